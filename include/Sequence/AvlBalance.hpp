@@ -0,0 +1,75 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+// Повороты и балансировка, общие для AVL-деревьев.
+// Узлу нужны поля left, right и height; Update::update пересчитывает
+// высоту и остальные поля поддерева, например число элементов.
+template <typename Node>
+int avl_height(const Node* node) {
+    return node ? node->height : 0;
+}
+
+template <typename Node>
+struct AvlHeightUpdate {
+    static void update(Node* node) {
+        node->height = std::max(avl_height(node->left), avl_height(node->right)) + 1;
+    }
+};
+
+template <typename Node, typename Update = AvlHeightUpdate<Node>>
+class AvlBalancer {
+public:
+    // высота AVL-дерева не больше 1.45 * log2(n + 2), 96 хватает для любого size_t
+    static constexpr size_t max_height = 96;
+
+    static int height_of(const Node* node) {
+        return avl_height(node);
+    }
+
+    static Node* rotate_right(Node* node) {
+        Node* left = node->left;
+        node->left = left->right;
+        left->right = node;
+        Update::update(node);
+        Update::update(left);
+        return left;
+    }
+
+    static Node* rotate_left(Node* node) {
+        Node* right = node->right;
+        node->right = right->left;
+        right->left = node;
+        Update::update(node);
+        Update::update(right);
+        return right;
+    }
+
+    static Node* balance(Node* node) {
+        Update::update(node);
+        int factor = height_of(node->left) - height_of(node->right);
+
+        if (factor > 1) {
+            if (height_of(node->left->left) < height_of(node->left->right))
+                node->left = rotate_left(node->left);
+            return rotate_right(node);
+        }
+
+        if (factor < -1) {
+            if (height_of(node->right->right) < height_of(node->right->left))
+                node->right = rotate_right(node->right);
+            return rotate_left(node);
+        }
+
+        return node;
+    }
+
+    // балансирует узлы на пути от изменённого места к корню;
+    // path[i] - ссылка на i-й узел пути в родителе
+    static void rebalance_path(Node** path[], size_t depth) {
+        while (depth > 0) {
+            Node** link = path[--depth];
+            *link = balance(*link);
+        }
+    }
+};
@@ -1,8 +1,12 @@
 #pragma once
+#include <algorithm>
 #include <sstream>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
 #include "TreeNode.hpp"
+#include "AvlBalance.hpp"
+#include "NodePool.hpp"
 #include "Traversal.hpp"
 #include "TreeIterator.hpp"
 
@@ -22,31 +26,79 @@ public:
 private:
     tnode* root;
     TreeTraversal<T>* traversal;
+    Node_Pool<tnode> pool;
 
 public:
     BinaryTree(TreeTraversal<T>* new_traversal = new InOrderTraversal<T>())
     : root(nullptr), traversal(new_traversal) {}
 
     ~BinaryTree() {
-        clear_r(root);
-        root = nullptr;
+        destroy_nodes();
         delete traversal;
     }
 
     void add(T value) {
-        root = add_r(root, value);
+        tnode** path[max_height];
+        size_t depth = 0;
+
+        tnode** link = &root;
+        while (*link) {
+            if (value < (*link)->data) {
+                path[depth++] = link;
+                link = &(*link)->left;
+            } else if (value > (*link)->data) {
+                path[depth++] = link;
+                link = &(*link)->right;
+            } else {
+                return;
+            }
+        }
+
+        *link = pool.create(value);
+        rebalance_path(path, depth);
     }
 
     TreeIterator<T> iterator() const {
         return TreeIterator<T>(root, traversal);
     }
 
+    // обход в заданном порядке, не меняя порядок дерева
+    TreeIterator<T> iterator(TreeTraversal<T>* order) const {
+        return TreeIterator<T>(root, order);
+    }
+
     void remove(const T& value) {
-        bool found = false;
-        root = remove_r(root, value, found);
-        if (!found) {
+        tnode** path[max_height];
+        size_t depth = 0;
+
+        tnode** link = &root;
+        while (*link && !(value == (*link)->data)) {
+            path[depth++] = link;
+            link = value < (*link)->data ? &(*link)->left : &(*link)->right;
+        }
+
+        if (!*link) {
             throw std::runtime_error("No such element");
         }
+
+        tnode* node = *link;
+        if (node->left && node->right) {
+            // на место значения встаёт следующее по порядку, удаляется его узел
+            path[depth++] = link;
+            tnode** successor = &node->right;
+            while ((*successor)->left) {
+                path[depth++] = successor;
+                successor = &(*successor)->left;
+            }
+
+            node->data = (*successor)->data;
+            link = successor;
+            node = *successor;
+        }
+
+        *link = node->left ? node->left : node->right;
+        pool.destroy(node);
+        rebalance_path(path, depth);
     }
 
     void set_traversal(TreeTraversal<T>* new_traversal){
@@ -54,85 +106,86 @@ public:
         traversal = new_traversal;
     }
 
-    bool contains(const T& value) {
-        auto it = iterator();
-        while (it.has_next()) {
-            if (it.next() == value) {
-                return true;
-            }
-        }
-        return false;
+    bool contains(const T& value) const {
+        return find_node(value) != nullptr;
     }
     
     BinaryTree<T>* extract_subtree(const T& value) {
         if (!root) throw std::runtime_error("root isn't init");
 
-        tnode* target_node = find_node_r(root, value);
+        tnode* target_node = find_node(value);
         if (!target_node) throw std::runtime_error("No such element");
 
         BinaryTree<T>* subtree = new BinaryTree<T>(traversal->clone());
-        subtree->root = clone_subtree_r(target_node);
+        subtree->root = clone_subtree_r(target_node, subtree->pool);
         return subtree;
     }
 
+    // для тривиально разрушаемых T память отдаётся блоками, без обхода узлов
+    void clear() {
+        destroy_nodes();
+        root = nullptr;
+        pool.release_all();
+    }
 
-private:
-    tnode* add_r(tnode* node, T value) {
-        if (node == nullptr) return new tnode(value);
-        if (value < node->data) node->left = add_r(node->left, value);
-        else if (value > node->data) node->right = add_r(node->right, value);
-        return node;
+    size_t get_size() const {
+        return pool.get_live_count();
     }
 
-    void clear_r(tnode* node) {
-        if (!node) return;
-        clear_r(node->left);
-        clear_r(node->right);
-        delete node;
+    int get_height() const {
+        return height_of(root);
     }
 
-    tnode* find_node_r(tnode* node, const T& value) {
-        if (!node) return nullptr;
-        if (value == node->data) return node;
-        if (value < node->data) return find_node_r(node->left, value);
-        return find_node_r(node->right, value);
+
+private:
+    using Balancer = AvlBalancer<tnode>;
+    static constexpr size_t max_height = Balancer::max_height;
+
+    static int height_of(tnode* node) {
+        return Balancer::height_of(node);
     }
 
-    tnode* clone_subtree_r(tnode* node) {
-        if (!node) return nullptr;
-        tnode* new_node = new tnode(node->data);
-        new_node->left = clone_subtree_r(node->left);
-        new_node->right = clone_subtree_r(node->right);
-        return new_node;
+    static void rebalance_path(tnode** path[], size_t depth) {
+        Balancer::rebalance_path(path, depth);
     }
 
-    tnode* remove_r(tnode* node, const T& value, bool& found) {
-        if (!node) return nullptr;
-    
-        if (value < node->data) {
-            node->left = remove_r(node->left, value, found);
-        } else if (value > node->data) {
-            node->right = remove_r(node->right, value, found);
-        } else {
-            found = true;
-    
-            if (!node->left) {
-                tnode* right = node->right;
-                delete node;
-                return right;
-            } else if (!node->right) {
+    // разбирает дерево поворотами вправо, без рекурсии и дополнительной памяти;
+    // узлы с тривиально разрушаемыми данными освобождает сам пул
+    void destroy_nodes() {
+        if (std::is_trivially_destructible<T>::value) return;
+
+        tnode* node = root;
+        while (node) {
+            if (node->left) {
                 tnode* left = node->left;
-                delete node;
-                return left;
+                node->left = left->right;
+                left->right = node;
+                node = left;
+            } else {
+                tnode* right = node->right;
+                pool.destroy(node);
+                node = right;
             }
-    
-            tnode* min_node = find_min_node(node->right);
-            node->data = min_node->data;
-            node->right = remove_r(node->right, min_node->data, found);
+        }
+    }
+
+    tnode* find_node(const T& value) const {
+        tnode* node = root;
+        while (node && !(value == node->data)) {
+            node = value < node->data ? node->left : node->right;
         }
         return node;
     }
 
+    static tnode* clone_subtree_r(tnode* node, Node_Pool<tnode>& target) {
+        if (!node) return nullptr;
+        tnode* new_node = target.create(node->data);
+        new_node->height = node->height;
+        new_node->left = clone_subtree_r(node->left, target);
+        new_node->right = clone_subtree_r(node->right, target);
+        return new_node;
+    }
+
 };
 
 template <typename T>
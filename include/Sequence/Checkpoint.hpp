@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+// формат файла: заголовок, state_count слов состояния генератора, count элементов
+struct Checkpoint_Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t count;
+    uint64_t state_count;
+};
+
+constexpr char checkpoint_magic[8] = {'L', 'A', 'Z', 'Y', 'S', 'E', 'Q', '\0'};
+constexpr uint32_t checkpoint_version = 1;
@@ -1,7 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <functional>
 #include <optional>
+#include <string>
+#include <vector>
 #include "ArraySequence.hpp"
 #include "ReadOnlyStream.hpp"
+#include "PipelineProfiler.hpp"
 #include"UniquePtr.hpp"
 #include"SharedPtr.hpp"
 #include"WeakPtr.hpp"
@@ -16,6 +21,31 @@ public:
     virtual T get_next() = 0;
     virtual bool has_next() = 0;
     virtual ~Generator() = default;
+
+    // произвольный доступ по индексу без продвижения генератора
+    virtual bool is_random_access() const { return false; }
+    virtual bool has_at(size_t) { return false; }
+    virtual T get_at(size_t) { throw std::runtime_error("Generator has no random access"); }
+
+    // позиция курсора для сохранения на диск, источники сохраняются отдельно
+    virtual void save_state(Array_Sequence<size_t>&) const {}
+    virtual void load_state(const Array_Sequence<size_t>& state) { check_state(state, 0); }
+    // load_state возвращает генератор к сохранённой позиции, а следующие
+    // элементы не зависят от истории владельца
+    virtual bool is_rewindable() const { return false; }
+
+    // сколько первых элементов гарантированно совпадает с previous
+    virtual size_t get_shared_prefix(const Lazy_Sequence<T>*) const { return 0; }
+
+    virtual std::string get_name() const { return "Generator"; }
+    virtual void get_upstream(std::vector<const Pipeline_Node*>&) const {}
+
+protected:
+    // состояние из контрольной точки должно быть от генератора того же вида
+    static void check_state(const Array_Sequence<size_t>& state, int expected) {
+        if (state.get_size() != expected)
+            throw std::runtime_error("Bad checkpoint: generator state doesn't match pipeline");
+    }
 };
 
 template <typename T>
@@ -55,6 +85,11 @@ public:
         return owner->get_materialized_count() >= arity;
     }
 
+
+    std::string get_name() const override {
+        return "Function";
+    }
+
 };
 
 template <typename T>
@@ -63,18 +98,21 @@ class Sequence_Generator : public Generator<T>
 private:
     Array_Sequence<T> sequence;
     size_t current_index;
+    size_t start_index;
 
 public:
     Sequence_Generator(const Array_Sequence<T>& seq)
         : sequence(seq)
     { 
         this->current_index = 0;
+        this->start_index = 0;
     } 
 
     Sequence_Generator(const Array_Sequence<T>& seq, size_t current_index)
         : sequence(seq)
     { 
         this->current_index = current_index;
+        this->start_index = current_index;
     } 
 
     ~Sequence_Generator() {}
@@ -89,6 +127,32 @@ public:
     bool has_next() override {
         return current_index < sequence.get_size();
     }
+
+    bool is_random_access() const override {
+        return true;
+    }
+
+    bool has_at(size_t index) override {
+        return start_index + index < (size_t)sequence.get_size();
+    }
+
+    T get_at(size_t index) override {
+        return sequence.get(start_index + index);
+    }
+
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(current_index);
+    }
+
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 1);
+        current_index = state.get(0);
+    }
+
+    std::string get_name() const override {
+        return "Sequence";
+    }
+
 };
 
 template <typename T>
@@ -130,6 +194,32 @@ public:
         bool can_use_second = second->has_next() || second_index < second->get_materialized_count();
         return can_use_first || can_use_second;
     }
+
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(first_index);
+        state.append(second_index);
+    }
+
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 2);
+        first_index = state.get(0);
+        second_index = state.get(1);
+    }
+
+    // элементы first идут первыми
+    size_t get_shared_prefix(const Lazy_Sequence<T>* previous) const override {
+        return first->get_shared_prefix(previous);
+    }
+
+    std::string get_name() const override {
+        return "Concat";
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        result.push_back(first.get());
+        result.push_back(second.get());
+    }
+
 };
 
 template <typename T>
@@ -182,6 +272,36 @@ public:
         bool can_use_added = added->has_next() || added_index < added->get_materialized_count();
         return can_use_initial || can_use_added;
     }
+
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(initial_index);
+        state.append(added_index);
+        state.append(current_index);
+    }
+
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 3);
+        initial_index = state.get(0);
+        added_index = state.get(1);
+        current_index = state.get(2);
+    }
+
+    // до места вставки идут элементы initial
+    size_t get_shared_prefix(const Lazy_Sequence<T>* previous) const override {
+        size_t prefix = initial->get_shared_prefix(previous);
+        if (insert_index == 0) return prefix;
+        return std::min(prefix, insert_index - 1);
+    }
+
+    std::string get_name() const override {
+        return "Insert";
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        result.push_back(initial.get());
+        result.push_back(added.get());
+    }
+
 };
 
 template <typename T>
@@ -217,6 +337,41 @@ public:
         bool can_use_seq = sequence->has_next() || current_index < sequence->get_materialized_count();
         return (current_index >= from_index && current_index <= to_index) && can_use_seq;
     }
+
+    bool is_random_access() const override {
+        return sequence->is_random_access();
+    }
+
+    bool has_at(size_t index) override {
+        return from_index + index <= to_index && sequence->has_at(from_index + index);
+    }
+
+    T get_at(size_t index) override {
+        return sequence->peek(from_index + index);
+    }
+
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(current_index);
+    }
+
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 1);
+        current_index = state.get(0);
+    }
+
+    size_t get_shared_prefix(const Lazy_Sequence<T>* previous) const override {
+        if (from_index != 0) return 0;
+        return std::min(sequence->get_shared_prefix(previous), to_index + 1);
+    }
+
+    std::string get_name() const override {
+        return "Subsequence";
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        result.push_back(sequence.get());
+    }
+
 };
 
 template <typename TOut, typename TIn>
@@ -250,6 +405,36 @@ public:
         bool can_use_seq = sequence->has_next() || current_index < sequence->get_materialized_count();
         return can_use_seq;
     }
+
+    bool is_random_access() const override {
+        return sequence->is_random_access();
+    }
+
+    bool has_at(size_t index) override {
+        return sequence->has_at(index);
+    }
+
+    TOut get_at(size_t index) override {
+        return func(sequence->peek(index));
+    }
+
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(current_index);
+    }
+
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 1);
+        current_index = state.get(0);
+    }
+
+    std::string get_name() const override {
+        return "Map";
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        result.push_back(sequence.get());
+    }
+
 };
 
 template <typename T>
@@ -298,6 +483,26 @@ public:
 
         return false;
     }
+
+    // найденный, но не выданный элемент будет прочитан из источника заново
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(cached_item.has_value() ? current_index - 1 : current_index);
+    }
+
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 1);
+        current_index = state.get(0);
+        cached_item.reset();
+    }
+
+    std::string get_name() const override {
+        return "Where";
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        result.push_back(sequence.get());
+    }
+
 };
 
 
@@ -307,21 +512,68 @@ class Stream_Generator : public Generator<T>
 private:
     Shared_Ptr<Read_Only_Stream<T>> stream;
 
+    // блок читается из потока одним вызовом; по умолчанию блок из одного
+    // элемента, чтобы не вычислять лишнего - крупный блок имеет смысл
+    // только для дешёвых источников вроде файлов
+    Unique_Ptr<T[]> buffer;
+    size_t block_size;
+    size_t buffer_begin;
+    size_t buffer_end;
+
 public:
-    Stream_Generator(Shared_Ptr<Read_Only_Stream<T>> stream) 
+    Stream_Generator(Shared_Ptr<Read_Only_Stream<T>> stream, size_t block_size = 1) 
     {
+        if (block_size == 0)
+            throw std::invalid_argument("Block size must be positive");
+
         this->stream = stream;
+        this->buffer = Unique_Ptr<T[]>(new T[block_size]);
+        this->block_size = block_size;
+        this->buffer_begin = 0;
+        this->buffer_end = 0;
     }
     
     T get_next() override {
         if (this->has_next())
-            return stream->read();
+            return buffer[buffer_begin++];
         
         throw std::runtime_error("Generation limit reached");
     }
     
     bool has_next() override {
-        return !stream->is_end_of_stream();
+        if (buffer_begin < buffer_end) return true;
+        if (stream->is_end_of_stream()) return false;
+
+        buffer_begin = 0;
+        buffer_end = stream->read(buffer.get(), block_size);
+        return buffer_end > 0;
     }
+
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(stream->get_position() - (buffer_end - buffer_begin));
+    }
+
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 1);
+        size_t position = state.get(0);
+        buffer_begin = buffer_end = 0;
+
+        if (position == stream->get_position()) return;
+        if (!stream->is_can_seek() || !stream->seek(position))
+            throw std::runtime_error("Stream position can't be restored");
+    }
+
+    bool is_rewindable() const override {
+        return stream->is_can_seek();
+    }
+
+    std::string get_name() const override {
+        return "Stream";
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        stream->get_upstream(result);
+    }
+
 };
 
@@ -3,19 +3,86 @@
 #include "Generator.hpp"
 #include "Sequence.hpp"
 #include "ArraySequence.hpp"
+#include "PackedSequence.hpp"
 #include "Cardinal.hpp"
 #include "UniquePtr.hpp"
 #include "SharedPtr.hpp"
+#include "PipelineProfiler.hpp"
+#include "WriteOnlyStream.hpp"
+#include "BufferedFile.hpp"
+#include "MappedFile.hpp"
+#include "Checkpoint.hpp"
+#include <algorithm>
+#include <cstring>
 #include <functional> 
+#include <limits>
+#include <type_traits>
 
 template <typename T>
-class Lazy_Sequence : public Enable_Shared_From_This<Lazy_Sequence<T>>
+class Lazy_Sequence : public Enable_Shared_From_This<Lazy_Sequence<T>>, public Pipeline_Node
 {
 private:
     Unique_Ptr<Generator<T>> generator;
     Unique_Ptr<Array_Sequence<T>> materialized_data;
+    Unique_Ptr<Packed_Sequence<T>> packed_data; // если задано, материализованное хранится сжатым
+    mutable Pipeline_Counters counters;
+
+    static constexpr bool can_compress = std::is_integral_v<T>;
 
 private:
+    void store(const T& item) {
+        if constexpr (can_compress) {
+            if (packed_data) {
+                packed_data->append(item);
+                return;
+            }
+        }
+        materialized_data->append(item);
+    }
+
+    T stored_at(size_t index) const {
+        if constexpr (can_compress) {
+            if (packed_data) return packed_data->get(index);
+        }
+        return materialized_data->get(index);
+    }
+
+    // проверяет заголовок и возвращает элементы прямо из отображённого файла
+    static const T* read_checkpoint(const Mapped_File& file, Array_Sequence<size_t>& state, size_t& count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Checkpoint requires trivially copyable T");
+
+        Checkpoint_Header header;
+        if (file.get_size() < sizeof(header))
+            throw std::runtime_error("Checkpoint file is too small");
+
+        std::memcpy(&header, file.get_data(), sizeof(header));
+        if (std::memcmp(header.magic, checkpoint_magic, sizeof(header.magic)) != 0)
+            throw std::runtime_error("Not a checkpoint file");
+        if (header.version != checkpoint_version)
+            throw std::runtime_error("Unsupported checkpoint version");
+        if (header.element_size != sizeof(T))
+            throw std::runtime_error("Checkpoint element size mismatch");
+
+        // Array_Sequence индексируется int, больший count не поместится
+        if (header.count > (uint64_t)std::numeric_limits<int>::max()
+            || header.state_count > (uint64_t)std::numeric_limits<int>::max())
+            throw std::runtime_error("Bad checkpoint: too many elements");
+
+        size_t data_offset = sizeof(header) + header.state_count * sizeof(uint64_t);
+        if (file.get_size() != data_offset + header.count * sizeof(T))
+            throw std::runtime_error("Checkpoint file is corrupted");
+
+        const char* state_data = file.get_data() + sizeof(header);
+        for (size_t i = 0; i < header.state_count; i++) {
+            uint64_t word;
+            std::memcpy(&word, state_data + i * sizeof(word), sizeof(word));
+            state.append(word);
+        }
+
+        count = header.count;
+        return reinterpret_cast<const T*>(file.get_data() + data_offset);
+    }
+
     void init_function_generator(size_t arity, std::function<T(const Sequence<T>&)> rule) {
         generator = my::make_unique<Function_Generator<T>>(
             this->shared_from_this(), arity, rule
@@ -66,6 +133,38 @@ public:
         );
     }
 
+    // generator должен быть построен так же, как при сохранении, его позиция восстанавливается
+    static Shared_Ptr<Lazy_Sequence<T>> load(const std::string& path, Unique_Ptr<Generator<T>>&& gen)
+    {
+        Mapped_File file(path);
+        Array_Sequence<size_t> state;
+        size_t count = 0;
+        const T* data = read_checkpoint(file, state, count);
+
+        auto l = Shared_Ptr<Lazy_Sequence<T>>(
+            new Lazy_Sequence<T>(std::move(gen))
+        );
+        l->materialized_data = my::make_unique<Array_Sequence<T>>(data, count);
+        if (l->generator) l->generator->load_state(state);
+        return l;
+    }
+
+    static Shared_Ptr<Lazy_Sequence<T>> load(const std::string& path,
+         size_t arity, std::function<T(const Array_Sequence<T>&)> rule)
+    {
+        Mapped_File file(path);
+        Array_Sequence<size_t> state;
+        size_t count = 0;
+        const T* data = read_checkpoint(file, state, count);
+
+        auto l = Shared_Ptr<Lazy_Sequence<T>>(
+            new Lazy_Sequence<T>()
+        );
+        l->materialized_data = my::make_unique<Array_Sequence<T>>(data, count);
+        l->init_function_generator(arity, rule);
+        return l;
+    }
+
     static Shared_Ptr<Lazy_Sequence<T>> create(const Sequence<T>& sequence) 
     {
         return Shared_Ptr<Lazy_Sequence<T>>(
@@ -73,37 +172,265 @@ public:
         );
     }
 
-    T get(size_t index) {
-        while (materialized_data->get_size() <= index && generator->has_next()) {
-            materialized_data->append(generator->get_next());
+    // материализует элементы, пока их меньше count и генератор не исчерпан
+    size_t materialize_to(size_t count) {
+        bool profiling = Pipeline_Profiler::is_enabled();
+
+        while (get_materialized_count() < count && this->has_next()) {
+            Pipeline_Timer timer(counters.time_spent, profiling);
+            store(generator->get_next());
+            if (profiling) counters.produced++;
         }
 
-        if (materialized_data->get_size() < index)
+        return get_materialized_count();
+    }
+
+    T get(size_t index) {
+        if (Pipeline_Profiler::is_enabled()) counters.get_calls++;
+
+        materialize_to(index + 1);
+
+        if (get_materialized_count() < index)
             throw std::runtime_error("Index beyond possible generation");
 
-        return materialized_data->get(index);
+        return stored_at(index);
     }
 
     T get_next() {
-        return this->get(materialized_data->get_size());
+        return this->get(get_materialized_count());
+    }
+
+    bool is_random_access() const {
+        return generator && generator->is_random_access();
+    }
+
+    // генерирует только то, без чего ответ невозможен
+    bool has_at(size_t index) {
+        size_t materialized = get_materialized_count();
+        if (index < materialized) return true;
+        if (is_random_access()) return generator->has_at(index);
+        if (index == materialized) return this->has_next();
+        return materialize_to(index + 1) > index;
+    }
+
+    // элемент за материализованным префиксом вычисляется без материализации,
+    // если генератор поддерживает произвольный доступ
+    T peek(size_t index) {
+        if (index < get_materialized_count())
+            return stored_at(index);
+
+        if (!is_random_access())
+            return this->get(index);
+
+        if (!generator->has_at(index))
+            throw std::runtime_error("Index beyond possible generation");
+
+        return generator->get_at(index);
     }
 
     T get_first_materialized() const {
-        return materialized_data->get_first();
+        if (get_materialized_count() == 0)
+            throw std::runtime_error("Sequence is empty");
+        return stored_at(0);
     }
 
     T get_last_materialized() const {
-        return materialized_data->get_last();
+        if (get_materialized_count() == 0)
+            throw std::runtime_error("Sequence is empty");
+        return stored_at(get_materialized_count() - 1);
     }
 
     size_t get_materialized_count() const {
+        if constexpr (can_compress) {
+            if (packed_data) return packed_data->get_size();
+        }
         return materialized_data->get_size();
     }
 
+    // непрерывный материализованный префикс, указатель меняется при росте;
+    // nullptr для сжатого хранилища
+    const T* get_materialized_data() const {
+        if (is_compressed() || materialized_data->get_size() == 0) return nullptr;
+        return &materialized_data->get(0);
+    }
+
+    void copy_materialized(size_t from, size_t count, T* out) const {
+        if constexpr (can_compress) {
+            if (packed_data) {
+                packed_data->copy_to(from, count, out);
+                return;
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i] = materialized_data->get(from + i);
+        }
+    }
+
+    size_t get_materialized_bytes() const {
+        if constexpr (can_compress) {
+            if (packed_data) return packed_data->get_memory_usage();
+        }
+        return get_materialized_count() * sizeof(T);
+    }
+
+    bool is_compressed() const {
+        return (bool)packed_data;
+    }
+
+    // дальнейшие материализованные элементы хранятся сжатыми, уже имеющиеся переносятся
+    void enable_compression() {
+        if constexpr (can_compress) {
+            if (packed_data) return;
+
+            packed_data = my::make_unique<Packed_Sequence<T>>();
+            for (int i = 0; i < materialized_data->get_size(); i++) {
+                packed_data->append(materialized_data->get(i));
+            }
+            materialized_data->reset();
+        } else {
+            throw std::runtime_error("Compression is available only for integer sequences");
+        }
+    }
+
     bool has_next() const {
+        bool profiling = Pipeline_Profiler::is_enabled();
+        if (profiling) counters.has_next_probes++;
+
+        Pipeline_Timer timer(counters.time_spent, profiling);
         return generator->has_next();
     }
 
+    std::string get_name() const override {
+        return generator ? generator->get_name() : "Empty";
+    }
+
+    Pipeline_Counters get_counters() const override {
+        Pipeline_Counters result = counters;
+        result.bytes_materialized = get_materialized_bytes();
+        return result;
+    }
+
+    // сколько первых элементов гарантированно совпадает с previous, от которого построена цепочка
+    size_t get_shared_prefix(const Lazy_Sequence<T>* previous) const {
+        if (previous == this) return std::numeric_limits<size_t>::max();
+        return generator ? generator->get_shared_prefix(previous) : 0;
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        if (generator) generator->get_upstream(result);
+    }
+
+    void dump_pipeline(std::ostream& out = std::cout) const {
+        ::dump_pipeline(*this, out);
+    }
+
+    void save(const std::string& path) const {
+        static_assert(std::is_trivially_copyable_v<T>, "Checkpoint requires trivially copyable T");
+
+        Array_Sequence<size_t> state;
+        if (generator) generator->save_state(state);
+
+        Checkpoint_Header header;
+        std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+        header.version = checkpoint_version;
+        header.element_size = sizeof(T);
+        header.count = get_materialized_count();
+        header.state_count = state.get_size();
+
+        Buffered_File file(path);
+        file.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for (int i = 0; i < state.get_size(); i++) {
+            uint64_t word = state.get(i);
+            file.append(reinterpret_cast<const char*>(&word), sizeof(word));
+        }
+
+        if (!is_compressed()) {
+            if (header.count > 0)
+                file.append(reinterpret_cast<const char*>(get_materialized_data()), header.count * sizeof(T));
+        } else {
+            constexpr size_t batch_size = 4096;
+            Unique_Ptr<T[]> batch(new T[batch_size]);
+            for (size_t from = 0; from < header.count; from += batch_size) {
+                size_t count = std::min(batch_size, (size_t)header.count - from);
+                copy_materialized(from, count, batch.get());
+                file.append(reinterpret_cast<const char*>(batch.get()), count * sizeof(T));
+            }
+        }
+
+        file.flush();
+    }
+
+    // пишет до n элементов начиная с from, в приёмник уходят целые блоки.
+    // Материализованная часть копируется из истории, остальное вычисляется
+    // в буфер без роста истории: по индексу или из генератора с откатом его позиции.
+    // Генераторы, которым нужна история (Function), материализуют как при get
+    size_t drain_to(Write_Only_Stream<T>& sink, size_t n, size_t from = 0) {
+        constexpr size_t batch_size = 4096;
+        size_t capacity = std::min(batch_size, std::max<size_t>(n, 1));
+        Unique_Ptr<T[]> batch(new T[capacity]);
+
+        size_t written = 0;
+        auto copy_history = [&](size_t limit) {
+            while (written < n && from + written < limit) {
+                size_t count = std::min({capacity, n - written, limit - (from + written)});
+                if (is_compressed()) {
+                    copy_materialized(from + written, count, batch.get());
+                    sink.write(batch.get(), count);
+                } else {
+                    sink.write(get_materialized_data() + from + written, count);
+                }
+                written += count;
+            }
+        };
+
+        copy_history(get_materialized_count());
+
+        if (written < n && is_random_access()) {
+            while (written < n) {
+                size_t count = 0;
+                while (count < std::min(capacity, n - written) && generator->has_at(from + written + count)) {
+                    batch[count] = generator->get_at(from + written + count);
+                    count++;
+                }
+                if (count == 0) break;
+
+                sink.write(batch.get(), count);
+                written += count;
+            }
+        } else if (written < n && generator && generator->is_rewindable()) {
+            Array_Sequence<size_t> state;
+            generator->save_state(state);
+
+            // до from генератор просто проматывается
+            for (size_t i = get_materialized_count(); i < from && generator->has_next(); i++) {
+                generator->get_next();
+            }
+
+            while (written < n) {
+                size_t count = 0;
+                while (count < std::min(capacity, n - written) && generator->has_next()) {
+                    batch[count++] = generator->get_next();
+                }
+                if (count == 0) break;
+
+                sink.write(batch.get(), count);
+                written += count;
+            }
+
+            generator->load_state(state);
+        } else if (written < n) {
+            while (written < n) {
+                size_t available = materialize_to(from + written + std::min(capacity, n - written));
+                if (available <= from + written) break;
+                copy_history(available);
+            }
+        }
+
+        sink.flush();
+        return written;
+    }
+
     Shared_Ptr<Lazy_Sequence<T>> append(Shared_Ptr<Lazy_Sequence<T>> items) {
         auto append_generator = my::make_unique<Concat_Generator<T>>(
             this->shared_from_this(), items
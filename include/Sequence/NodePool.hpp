@@ -0,0 +1,84 @@
+#pragma once
+#include <new>
+#include <utility>
+#include <vector>
+#include "UniquePtr.hpp"
+
+// Пул узлов одного типа. Узлы нарезаются из непрерывных блоков,
+// каждый следующий блок вдвое больше, освобождённые ячейки
+// идут в список свободных и выдаются повторно.
+// release_all отдаёт всю память разом за O(блоков), деструкторы узлов не вызываются.
+template <typename Node>
+class Node_Pool {
+private:
+    union Slot {
+        Slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    static constexpr size_t first_block = 64;
+    static constexpr size_t max_block = 4096;
+
+    std::vector<Unique_Ptr<Slot[]>> blocks;
+    size_t block_capacity; // ячеек в последнем блоке
+    size_t used;           // выдано ячеек из последнего блока
+    Slot* free_list;
+    size_t live;
+
+private:
+    Slot* take_slot() {
+        if (free_list) {
+            Slot* slot = free_list;
+            free_list = slot->next;
+            return slot;
+        }
+
+        if (blocks.empty() || used == block_capacity) {
+            if (!blocks.empty() && block_capacity < max_block) block_capacity *= 2;
+            blocks.push_back(Unique_Ptr<Slot[]>(new Slot[block_capacity]));
+            used = 0;
+        }
+        return &blocks.back()[used++];
+    }
+
+public:
+    Node_Pool() : block_capacity(first_block), used(0), free_list(nullptr), live(0) {}
+
+    Node_Pool(const Node_Pool&) = delete;
+    Node_Pool& operator=(const Node_Pool&) = delete;
+
+    template <typename... Args>
+    Node* create(Args&&... args) {
+        Slot* slot = take_slot();
+        Node* node = new (slot->storage) Node(std::forward<Args>(args)...);
+        live++;
+        return node;
+    }
+
+    void destroy(Node* node) {
+        node->~Node();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->next = free_list;
+        free_list = slot;
+        live--;
+    }
+
+    // последний, самый большой блок остаётся для следующих вставок
+    void release_all() {
+        if (blocks.size() > 1) {
+            blocks.front() = std::move(blocks.back());
+            blocks.resize(1);
+        }
+        used = 0;
+        free_list = nullptr;
+        live = 0;
+    }
+
+    size_t get_live_count() const {
+        return live;
+    }
+
+    size_t get_block_count() const {
+        return blocks.size();
+    }
+};
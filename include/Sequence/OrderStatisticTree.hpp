@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include "AvlBalance.hpp"
+
+// AVL-дерево порядковых статистик: одинаковые значения хранятся в одном узле
+// со счётчиком, а каждый узел знает число элементов в своём поддереве.
+// Вставка, удаление, select(k) и rank(x) - O(log n).
+template <typename T>
+class OrderStatisticTree {
+private:
+    struct Node {
+        T data;
+        size_t count;  // повторы значения
+        size_t size;   // элементов в поддереве с учётом повторов
+        int height;
+        Node* left;
+        Node* right;
+
+        Node(const T& value)
+        : data(value), count(1), size(1), height(1), left(nullptr), right(nullptr) {}
+    };
+
+    Node* root;
+
+public:
+    OrderStatisticTree() : root(nullptr) {}
+
+    OrderStatisticTree(const OrderStatisticTree& other) : root(clone_r(other.root)) {}
+
+    OrderStatisticTree(OrderStatisticTree&& other) noexcept : root(other.root) {
+        other.root = nullptr;
+    }
+
+    OrderStatisticTree& operator=(OrderStatisticTree other) noexcept {
+        std::swap(root, other.root);
+        return *this;
+    }
+
+    ~OrderStatisticTree() {
+        clear_r(root);
+    }
+
+    void insert(const T& value) {
+        root = insert_r(root, value);
+    }
+
+    // удаляет одно вхождение value
+    void erase(const T& value) {
+        bool found = false;
+        root = erase_r(root, value, found);
+        if (!found) {
+            throw std::runtime_error("No such element");
+        }
+    }
+
+    // k-й по возрастанию элемент, с нуля
+    const T& select(size_t k) const {
+        if (k >= get_size())
+            throw std::out_of_range("OrderStatisticTree::select index out of range");
+
+        Node* node = root;
+        while (true) {
+            size_t left_size = size_of(node->left);
+            if (k < left_size) {
+                node = node->left;
+            } else if (k < left_size + node->count) {
+                return node->data;
+            } else {
+                k -= left_size + node->count;
+                node = node->right;
+            }
+        }
+    }
+
+    // число элементов строго меньше value
+    size_t rank(const T& value) const {
+        size_t result = 0;
+        Node* node = root;
+        while (node) {
+            if (value < node->data) {
+                node = node->left;
+            } else if (node->data < value) {
+                result += size_of(node->left) + node->count;
+                node = node->right;
+            } else {
+                return result + size_of(node->left);
+            }
+        }
+        return result;
+    }
+
+    size_t count(const T& value) const {
+        Node* node = root;
+        while (node) {
+            if (value < node->data) node = node->left;
+            else if (node->data < value) node = node->right;
+            else return node->count;
+        }
+        return 0;
+    }
+
+    size_t get_size() const {
+        return size_of(root);
+    }
+
+    int get_height() const {
+        return height_of(root);
+    }
+
+    void clear() {
+        clear_r(root);
+        root = nullptr;
+    }
+
+private:
+    static size_t size_of(Node* node) {
+        return node ? node->size : 0;
+    }
+
+    // кроме высоты узел хранит размер поддерева
+    struct SizeUpdate {
+        static void update(Node* node) {
+            node->size = size_of(node->left) + size_of(node->right) + node->count;
+            AvlHeightUpdate<Node>::update(node);
+        }
+    };
+
+    using Balancer = AvlBalancer<Node, SizeUpdate>;
+
+    static int height_of(Node* node) {
+        return Balancer::height_of(node);
+    }
+
+    static Node* balance(Node* node) {
+        return Balancer::balance(node);
+    }
+
+    Node* insert_r(Node* node, const T& value) {
+        if (!node) return new Node(value);
+
+        if (value < node->data) node->left = insert_r(node->left, value);
+        else if (node->data < value) node->right = insert_r(node->right, value);
+        else node->count++;
+
+        return balance(node);
+    }
+
+    // отцепляет минимальный узел поддерева, не удаляя его
+    Node* detach_min_r(Node* node, Node*& min_node) {
+        if (!node->left) {
+            min_node = node;
+            return node->right;
+        }
+
+        node->left = detach_min_r(node->left, min_node);
+        return balance(node);
+    }
+
+    Node* erase_r(Node* node, const T& value, bool& found) {
+        if (!node) return nullptr;
+
+        if (value < node->data) {
+            node->left = erase_r(node->left, value, found);
+        } else if (node->data < value) {
+            node->right = erase_r(node->right, value, found);
+        } else {
+            found = true;
+
+            if (node->count > 1) {
+                node->count--;
+            } else {
+                Node* left = node->left;
+                Node* right = node->right;
+                delete node;
+
+                if (!right) return left;
+
+                Node* min_node = nullptr;
+                right = detach_min_r(right, min_node);
+                min_node->left = left;
+                min_node->right = right;
+                return balance(min_node);
+            }
+        }
+
+        return balance(node);
+    }
+
+    void clear_r(Node* node) {
+        if (!node) return;
+        clear_r(node->left);
+        clear_r(node->right);
+        delete node;
+    }
+
+    Node* clone_r(Node* node) const {
+        if (!node) return nullptr;
+
+        Node* copy = new Node(node->data);
+        copy->count = node->count;
+        copy->size = node->size;
+        copy->height = node->height;
+        copy->left = clone_r(node->left);
+        copy->right = clone_r(node->right);
+        return copy;
+    }
+};
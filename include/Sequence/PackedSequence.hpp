@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Сжатое хранилище целых чисел только на добавление.
+// Элементы упаковываются блоками по block_size: в каждом блоке значения
+// приближаются прямой base + slope * i, а отклонения от неё хранятся
+// смещениями от минимального с одинаковой битовой шириной.
+// Арифметические прогрессии занимают 0 бит на элемент, доступ по индексу O(1).
+template <typename T>
+class Packed_Sequence
+{
+public:
+    static constexpr size_t block_size = 128;
+
+private:
+    struct Block {
+        uint64_t base;
+        uint64_t slope;
+        uint64_t min_residual;
+        size_t offset; // первое слово блока в words
+        unsigned width;
+    };
+
+    std::vector<Block> blocks;
+    std::vector<uint64_t> words;
+
+    T tail[block_size]; // ещё не упакованный хвост
+    size_t tail_size = 0;
+
+private:
+    static uint64_t to_bits(const T& value) {
+        return static_cast<uint64_t>(value);
+    }
+
+    static unsigned bit_width(uint64_t value) {
+        return value == 0 ? 0 : 64 - __builtin_clzll(value);
+    }
+
+    static uint64_t predict(const Block& block, size_t i) {
+        return block.base + block.slope * i;
+    }
+
+    static uint64_t read_bits(const uint64_t* data, size_t bit, unsigned width) {
+        if (width == 0) return 0;
+
+        size_t word = bit / 64;
+        unsigned shift = bit % 64;
+
+        uint64_t value = data[word] >> shift;
+        if (shift + width > 64)
+            value |= data[word + 1] << (64 - shift);
+
+        return width == 64 ? value : value & ((uint64_t(1) << width) - 1);
+    }
+
+    void pack_tail() {
+        Block block;
+        block.base = to_bits(tail[0]);
+
+        int64_t delta = (int64_t)(to_bits(tail[block_size - 1]) - block.base);
+        block.slope = (uint64_t)(delta / (int64_t)(block_size - 1));
+
+        uint64_t residuals[block_size];
+        int64_t min_residual = 0;
+        for (size_t i = 0; i < block_size; i++) {
+            residuals[i] = to_bits(tail[i]) - predict(block, i);
+            if (i == 0 || (int64_t)residuals[i] < min_residual)
+                min_residual = (int64_t)residuals[i];
+        }
+        block.min_residual = (uint64_t)min_residual;
+
+        uint64_t max_offset = 0;
+        for (size_t i = 0; i < block_size; i++) {
+            residuals[i] -= block.min_residual;
+            if (residuals[i] > max_offset) max_offset = residuals[i];
+        }
+
+        block.width = bit_width(max_offset);
+        block.offset = words.size();
+        words.resize(words.size() + block_size * block.width / 64, 0);
+
+        uint64_t* data = words.data() + block.offset;
+        for (size_t i = 0; i < block_size && block.width > 0; i++) {
+            size_t bit = i * block.width;
+            size_t word = bit / 64;
+            unsigned shift = bit % 64;
+
+            data[word] |= residuals[i] << shift;
+            if (shift + block.width > 64)
+                data[word + 1] |= residuals[i] >> (64 - shift);
+        }
+
+        blocks.push_back(block);
+        tail_size = 0;
+    }
+
+public:
+    void append(const T& item) {
+        tail[tail_size++] = item;
+        if (tail_size == block_size) pack_tail();
+    }
+
+    T get(size_t index) const {
+        if (index >= get_size())
+            throw std::out_of_range("Packed_Sequence::get index out of range");
+
+        size_t block_index = index / block_size;
+        size_t i = index % block_size;
+        if (block_index == blocks.size()) return tail[i];
+
+        const Block& block = blocks[block_index];
+        uint64_t offset = read_bits(words.data() + block.offset, i * block.width, block.width);
+        return static_cast<T>(predict(block, i) + block.min_residual + offset);
+    }
+
+    // последовательная распаковка диапазона
+    void copy_to(size_t from, size_t count, T* out) const {
+        if (from + count > get_size())
+            throw std::out_of_range("Packed_Sequence::copy_to range out of range");
+
+        size_t index = from;
+        size_t end = from + count;
+        while (index < end) {
+            size_t block_index = index / block_size;
+            size_t i = index % block_size;
+            size_t block_end = std::min(end, (block_index + 1) * block_size);
+
+            if (block_index == blocks.size()) {
+                for (; index < block_end; index++, i++) *out++ = tail[i];
+                continue;
+            }
+
+            const Block& block = blocks[block_index];
+            const uint64_t* data = words.data() + block.offset;
+            for (; index < block_end; index++, i++) {
+                uint64_t offset = read_bits(data, i * block.width, block.width);
+                *out++ = static_cast<T>(predict(block, i) + block.min_residual + offset);
+            }
+        }
+    }
+
+    size_t get_size() const {
+        return blocks.size() * block_size + tail_size;
+    }
+
+    size_t get_memory_usage() const {
+        return blocks.size() * sizeof(Block) + words.size() * sizeof(uint64_t) + sizeof(tail);
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Pipeline_Counters {
+    size_t produced = 0;            // элементов получено от генератора
+    size_t has_next_probes = 0;
+    size_t get_calls = 0;           // обращений к get() со стороны потребителей
+    size_t bytes_materialized = 0;
+    std::chrono::nanoseconds time_spent{0}; // включая время вышестоящих стадий
+};
+
+class Pipeline_Profiler {
+private:
+    // читается и из рабочих потоков каналов и предвыборки
+    inline static std::atomic<bool> enabled{false};
+
+public:
+    static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+    static void set_enabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+};
+
+class Pipeline_Timer {
+private:
+    std::chrono::nanoseconds* target;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    Pipeline_Timer(std::chrono::nanoseconds& time, bool enabled)
+        : target(enabled ? &time : nullptr)
+    {
+        if (target) start = std::chrono::steady_clock::now();
+    }
+
+    ~Pipeline_Timer() {
+        if (target) *target += std::chrono::steady_clock::now() - start;
+    }
+
+    Pipeline_Timer(const Pipeline_Timer&) = delete;
+    Pipeline_Timer& operator=(const Pipeline_Timer&) = delete;
+};
+
+// узел графа стадий, не зависит от типа элементов
+class Pipeline_Node {
+public:
+    virtual ~Pipeline_Node() = default;
+
+    virtual std::string get_name() const = 0;
+    virtual Pipeline_Counters get_counters() const = 0;
+    virtual void get_upstream(std::vector<const Pipeline_Node*>& result) const = 0;
+};
+
+void dump_pipeline(const Pipeline_Node& root, std::ostream& out = std::cout);
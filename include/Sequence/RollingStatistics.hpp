@@ -0,0 +1,87 @@
+#pragma once
+#include <functional>
+#include <stdexcept>
+#include "LazySequence.hpp"
+#include "WindowedMedian.hpp"
+#include "WindowedQuantile.hpp"
+
+// скользящая статистика: на каждый элемент источника - значение по окну из последних элементов
+template <typename T, typename Window>
+class Rolling_Generator : public Generator<double> 
+{
+private:
+    Shared_Ptr<Lazy_Sequence<T>> sequence;
+    size_t current_index;
+
+    Window window;
+    std::function<double(const Window&)> statistic;
+
+public:
+    Rolling_Generator(Shared_Ptr<Lazy_Sequence<T>> seq, Window window, std::function<double(const Window&)> statistic)
+        : sequence(seq), current_index(0), window(std::move(window)), statistic(statistic) {}
+
+    double get_next() override {
+        if (!this->has_next())
+            throw std::runtime_error("Generation limit reached");
+
+        window.add(sequence->get(current_index++));
+        return statistic(window);
+    }
+
+    bool has_next() override {
+        return sequence->has_next() || current_index < sequence->get_materialized_count();
+    }
+
+    void save_state(Array_Sequence<size_t>& state) const override {
+        state.append(current_index);
+    }
+
+    // окно восстанавливается из уже материализованных элементов источника
+    void load_state(const Array_Sequence<size_t>& state) override {
+        this->check_state(state, 1);
+        current_index = state.get(0);
+
+        window.clear();
+        size_t from = current_index > window.get_window() ? current_index - window.get_window() : 0;
+        for (size_t i = from; i < current_index; i++) {
+            window.add(sequence->get(i));
+        }
+    }
+
+    std::string get_name() const override {
+        return "Rolling";
+    }
+
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        result.push_back(sequence.get());
+    }
+
+};
+
+// медиана последних window элементов, по значению на каждый элемент
+template <typename T>
+Shared_Ptr<Lazy_Sequence<double>> rolling_median(Shared_Ptr<Lazy_Sequence<T>> sequence, size_t window)
+{
+    auto rolling_generator = my::make_unique<Rolling_Generator<T, Windowed_Median<T>>>(
+        sequence,
+        Windowed_Median<T>(window),
+        [](const Windowed_Median<T>& w) { return w.get_median(); }
+    );
+
+    return my::make_shared<Lazy_Sequence<double>>(std::move(rolling_generator));
+}
+
+template <typename T>
+Shared_Ptr<Lazy_Sequence<double>> rolling_quantile(Shared_Ptr<Lazy_Sequence<T>> sequence, size_t window, double q)
+{
+    if (q < 0.0 || q > 1.0)
+        throw std::invalid_argument("Quantile must be in [0, 1]");
+
+    auto rolling_generator = my::make_unique<Rolling_Generator<T, Windowed_Quantile<T>>>(
+        sequence,
+        Windowed_Quantile<T>(window),
+        [q](const Windowed_Quantile<T>& w) { return w.quantile(q); }
+    );
+
+    return my::make_shared<Lazy_Sequence<double>>(std::move(rolling_generator));
+}
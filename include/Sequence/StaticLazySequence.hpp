@@ -0,0 +1,312 @@
+#pragma once
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "LazySequence.hpp"
+#include "ArraySequence.hpp"
+#include "UniquePtr.hpp"
+#include "SharedPtr.hpp"
+
+// Генераторы без виртуальных функций: стадии хранятся по значению,
+// поэтому вся цепочка известна компилятору и может быть встроена.
+// Каждый генератор объявляет value_type, get_next() и has_next().
+
+template <typename T>
+class Static_Sequence_Generator
+{
+private:
+    Array_Sequence<T> sequence;
+    size_t current_index;
+
+public:
+    using value_type = T;
+
+    Static_Sequence_Generator(const Array_Sequence<T>& seq)
+        : sequence(seq), current_index(0) {}
+
+    T get_next() {
+        if (this->has_next())
+            return sequence.get(current_index++);
+
+        throw std::runtime_error("Generation limit reached");
+    }
+
+    bool has_next() {
+        return current_index < (size_t)sequence.get_size();
+    }
+};
+
+template <typename T, typename Rule>
+class Static_Function_Generator
+{
+private:
+    Array_Sequence<T> start;
+    size_t start_index;
+
+    Array_Sequence<T> window; // последние arity элементов - аргументы правила
+    size_t arity;
+    size_t filled;
+
+    Rule rule;
+
+private:
+    void push_to_window(const T& item) {
+        if (arity == 0) return;
+
+        if (filled < arity) {
+            window.set(filled++, item);
+            return;
+        }
+
+        for (size_t i = 1; i < arity; i++) {
+            window.set(i - 1, window.get(i));
+        }
+        window.set(arity - 1, item);
+    }
+
+public:
+    using value_type = T;
+
+    Static_Function_Generator(const Array_Sequence<T>& start_seq, size_t arity, Rule rule)
+        : start(start_seq), start_index(0), window(arity), arity(arity), filled(0), rule(std::move(rule)) {}
+
+    T get_next() {
+        if (start_index < (size_t)start.get_size()) {
+            T item = start.get(start_index++);
+            push_to_window(item);
+            return item;
+        }
+
+        if (filled < arity)
+            throw std::runtime_error("Not enough elements to generate next");
+
+        T item = rule(window);
+        push_to_window(item);
+        return item;
+    }
+
+    bool has_next() {
+        return start_index < (size_t)start.get_size() || filled >= arity;
+    }
+};
+
+template <typename Upstream, typename Func>
+class Static_Map_Generator
+{
+private:
+    Upstream upstream;
+    Func func;
+
+public:
+    using value_type = std::decay_t<std::invoke_result_t<Func&, const typename Upstream::value_type&>>;
+
+    Static_Map_Generator(Upstream upstream, Func func)
+        : upstream(std::move(upstream)), func(std::move(func)) {}
+
+    value_type get_next() {
+        if (this->has_next())
+            return func(upstream.get_next());
+
+        throw std::runtime_error("Generation limit reached");
+    }
+
+    bool has_next() {
+        return upstream.has_next();
+    }
+};
+
+template <typename Upstream, typename Pred>
+class Static_Where_Generator
+{
+public:
+    using value_type = typename Upstream::value_type;
+
+private:
+    Upstream upstream;
+    Pred pred;
+    std::optional<value_type> cached_item;
+
+public:
+    Static_Where_Generator(Upstream upstream, Pred pred)
+        : upstream(std::move(upstream)), pred(std::move(pred)), cached_item(std::nullopt) {}
+
+    value_type get_next() {
+        if (this->has_next()) {
+            value_type result = *cached_item;
+            cached_item.reset();
+            return result;
+        }
+
+        throw std::runtime_error("Generation limit reached");
+    }
+
+    bool has_next() {
+        if (cached_item.has_value())
+            return true;
+
+        while (upstream.has_next()) {
+            value_type item = upstream.get_next();
+
+            if (pred(item)) {
+                cached_item = item;
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+template <typename First, typename Second>
+class Static_Concat_Generator
+{
+private:
+    First first;
+    Second second;
+
+public:
+    using value_type = typename First::value_type;
+
+    static_assert(std::is_same_v<value_type, typename Second::value_type>,
+                  "Concatenated generators must produce the same type");
+
+    Static_Concat_Generator(First first, Second second)
+        : first(std::move(first)), second(std::move(second)) {}
+
+    value_type get_next() {
+        if (first.has_next())
+            return first.get_next();
+
+        if (second.has_next())
+            return second.get_next();
+
+        throw std::runtime_error("Generation limit reached");
+    }
+
+    bool has_next() {
+        return first.has_next() || second.has_next();
+    }
+};
+
+// Единственная виртуальная граница: статическая цепочка под интерфейсом Generator<T>
+template <typename Gen>
+class Static_Generator_Adapter : public Generator<typename Gen::value_type>
+{
+private:
+    Gen generator;
+
+public:
+    Static_Generator_Adapter(Gen gen) : generator(std::move(gen)) {}
+
+    typename Gen::value_type get_next() override {
+        return generator.get_next();
+    }
+
+    bool has_next() override {
+        return generator.has_next();
+    }
+
+    std::string get_name() const override {
+        return "Static";
+    }
+};
+
+
+template <typename T, typename Gen>
+class Static_Lazy_Sequence
+{
+    static_assert(std::is_same_v<T, typename Gen::value_type>,
+                  "Generator must produce elements of type T");
+
+private:
+    Gen source;    // нетронутая копия цепочки, из неё строятся новые стадии
+    Gen generator;
+    Array_Sequence<T> materialized_data;
+
+public:
+    using generator_type = Gen;
+
+    explicit Static_Lazy_Sequence(Gen gen)
+        : source(gen), generator(std::move(gen)) {}
+
+    T get(size_t index) {
+        while ((size_t)materialized_data.get_size() <= index && generator.has_next()) {
+            materialized_data.append(generator.get_next());
+        }
+
+        if ((size_t)materialized_data.get_size() <= index)
+            throw std::runtime_error("Index beyond possible generation");
+
+        return materialized_data.get(index);
+    }
+
+    T get_next() {
+        return this->get(materialized_data.get_size());
+    }
+
+    T get_first_materialized() const {
+        return materialized_data.get_first();
+    }
+
+    T get_last_materialized() const {
+        return materialized_data.get_last();
+    }
+
+    size_t get_materialized_count() const {
+        return materialized_data.get_size();
+    }
+
+    bool has_next() {
+        return generator.has_next();
+    }
+
+    template <typename Func>
+    auto map(Func func) const {
+        using Map_Gen = Static_Map_Generator<Gen, Func>;
+        return Static_Lazy_Sequence<typename Map_Gen::value_type, Map_Gen>(Map_Gen(source, std::move(func)));
+    }
+
+    template <typename Pred>
+    auto where(Pred pred) const {
+        using Where_Gen = Static_Where_Generator<Gen, Pred>;
+        return Static_Lazy_Sequence<T, Where_Gen>(Where_Gen(source, std::move(pred)));
+    }
+
+    template <typename Gen2>
+    auto append(const Static_Lazy_Sequence<T, Gen2>& items) const {
+        using Concat_Gen = Static_Concat_Generator<Gen, Gen2>;
+        return Static_Lazy_Sequence<T, Concat_Gen>(Concat_Gen(source, items.source));
+    }
+
+    template <typename Gen2>
+    auto prepend(const Static_Lazy_Sequence<T, Gen2>& items) const {
+        using Concat_Gen = Static_Concat_Generator<Gen2, Gen>;
+        return Static_Lazy_Sequence<T, Concat_Gen>(Concat_Gen(items.source, source));
+    }
+
+    Shared_Ptr<Lazy_Sequence<T>> erase() const {
+        return Lazy_Sequence<T>::create(my::make_unique<Static_Generator_Adapter<Gen>>(source));
+    }
+
+    template <typename U, typename G>
+    friend class Static_Lazy_Sequence;
+};
+
+
+template <typename T>
+Static_Lazy_Sequence<T, Static_Sequence_Generator<T>> make_static_lazy_sequence(const Sequence<T>& sequence)
+{
+    return Static_Lazy_Sequence<T, Static_Sequence_Generator<T>>(
+        Static_Sequence_Generator<T>(Array_Sequence<T>(sequence))
+    );
+}
+
+template <typename T, typename Rule>
+Static_Lazy_Sequence<T, Static_Function_Generator<T, Rule>> make_static_lazy_sequence(const Sequence<T>& start_sequence,
+    size_t arity, Rule rule)
+{
+    return Static_Lazy_Sequence<T, Static_Function_Generator<T, Rule>>(
+        Static_Function_Generator<T, Rule>(Array_Sequence<T>(start_sequence), arity, std::move(rule))
+    );
+}
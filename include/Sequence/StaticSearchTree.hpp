@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "ArraySequence.hpp"
+#include "BinaryTree.hpp"
+
+// Неизменяемое дерево поиска в раскладке Эйтцингера: узел k хранит
+// потомков в 2k и 2k + 1, ключи лежат в одном массиве без указателей.
+// Поиск без ветвлений по данным, с предвыборкой на несколько уровней вперёд:
+// все потомки узла через log2(элементов в строке кэша) уровней лежат в одной строке.
+// Строится за O(n) из отсортированных данных или из BinaryTree.
+template <typename T>
+class Static_Search_Tree {
+private:
+    static constexpr size_t cache_line = 64;
+    static constexpr size_t line_elements =
+        sizeof(T) < cache_line && cache_line % sizeof(T) == 0 ? cache_line / sizeof(T) : 1;
+
+    std::vector<T> storage;
+    size_t offset; // keys()[0] выровнен по строке кэша, сами ключи с 1
+    size_t size;
+
+private:
+    const T* keys() const {
+        return storage.data() + offset;
+    }
+
+    T* keys() {
+        return storage.data() + offset;
+    }
+
+    void allocate(size_t n) {
+        size = n;
+        storage.assign(n + 1 + line_elements, T());
+
+        uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+        size_t misalignment = address % cache_line;
+        offset = 0;
+        if (line_elements > 1 && misalignment % sizeof(T) == 0 && misalignment != 0)
+            offset = (cache_line - misalignment) / sizeof(T);
+    }
+
+    static size_t leftmost(size_t k, size_t n) {
+        while (2 * k <= n) k = 2 * k;
+        return k;
+    }
+
+    // раскладывает n значений, приходящих по возрастанию, симметричным обходом
+    template <typename Next>
+    void fill(size_t n, Next next) {
+        allocate(n);
+        if (n == 0) return;
+
+        T* data = keys();
+        size_t k = leftmost(1, n);
+        for (size_t i = 0; i < n; i++) {
+            data[k] = next();
+
+            if (2 * k + 1 <= n) {
+                k = leftmost(2 * k + 1, n);
+            } else {
+                while (k & 1) k >>= 1;
+                k >>= 1;
+            }
+        }
+    }
+
+    // номер первого ключа не меньше value, 0 - таких нет
+    size_t lower_bound_index(const T& value) const {
+        const T* data = keys();
+        uintptr_t base = reinterpret_cast<uintptr_t>(data);
+
+        size_t k = 1;
+        while (k <= size) {
+            __builtin_prefetch(reinterpret_cast<const void*>(base + k * line_elements * sizeof(T)));
+            k = 2 * k + (data[k] < value);
+        }
+
+        // снимаем правые повороты и последний левый
+        k >>= __builtin_ffsll(~(long long)k);
+        return k;
+    }
+
+public:
+    Static_Search_Tree() : offset(0), size(0) {
+        allocate(0);
+    }
+
+    // у копии свой буфер, выравнивание считается заново
+    Static_Search_Tree(const Static_Search_Tree& other) : offset(0), size(0) {
+        allocate(other.size);
+        std::copy(other.keys() + 1, other.keys() + 1 + size, keys() + 1);
+    }
+
+    // при перемещении буфер переходит целиком и остаётся выровненным
+    Static_Search_Tree(Static_Search_Tree&& other) noexcept
+        : storage(std::move(other.storage)), offset(other.offset), size(other.size)
+    {
+        other.offset = 0;
+        other.size = 0;
+    }
+
+    Static_Search_Tree& operator=(const Static_Search_Tree& other) {
+        if (this != &other) {
+            Static_Search_Tree copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    Static_Search_Tree& operator=(Static_Search_Tree&& other) noexcept {
+        if (this != &other) {
+            storage = std::move(other.storage);
+            offset = other.offset;
+            size = other.size;
+            other.offset = 0;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    Static_Search_Tree(const T* sorted, size_t n) : offset(0), size(0) {
+        for (size_t i = 1; i < n; i++) {
+            if (sorted[i] < sorted[i - 1])
+                throw std::invalid_argument("Data must be sorted");
+        }
+
+        size_t i = 0;
+        fill(n, [&]() { return sorted[i++]; });
+    }
+
+    explicit Static_Search_Tree(const Array_Sequence<T>& sorted) : offset(0), size(0) {
+        int n = sorted.get_size();
+        for (int i = 1; i < n; i++) {
+            if (sorted.get(i) < sorted.get(i - 1))
+                throw std::invalid_argument("Sequence must be sorted");
+        }
+
+        int i = 0;
+        fill((size_t)n, [&]() { return sorted.get(i++); });
+    }
+
+    // ключи дерева уже упорядочены, достаточно симметричного обхода
+    explicit Static_Search_Tree(const BinaryTree<T>& tree) : offset(0), size(0) {
+        InOrderTraversal<T> in_order;
+        auto it = tree.iterator(&in_order);
+        fill(tree.get_size(), [&]() { return it.next(); });
+    }
+
+    bool contains(const T& value) const {
+        size_t k = lower_bound_index(value);
+        return k != 0 && !(value < keys()[k]);
+    }
+
+    // первый ключ не меньше value, nullptr - все ключи меньше
+    const T* lower_bound(const T& value) const {
+        size_t k = lower_bound_index(value);
+        return k == 0 ? nullptr : keys() + k;
+    }
+
+    size_t get_size() const {
+        return size;
+    }
+
+    bool is_aligned() const {
+        return line_elements == 1 || reinterpret_cast<uintptr_t>(keys()) % cache_line == 0;
+    }
+};
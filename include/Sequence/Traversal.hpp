@@ -1,24 +1,53 @@
 #pragma once
 #include <functional> 
+#include <vector>
 #include "BinaryTree.hpp"
 #include "TreeNode.hpp"
 
+// Обход дерева по шагам: в стеке лежат только узлы текущей ветки,
+// поэтому памяти O(высоты), а каждый узел кладётся и снимается один раз
 template <typename T>
 class TreeTraversal {
 public:
-    virtual void traverse(TreeNode<T>* root, std::vector<TreeNode<T>*>& result) = 0;
+    using Stack = std::vector<TreeNode<T>*>;
+
+    virtual void start(TreeNode<T>* root, Stack& stack) = 0;
+    // следующий узел обхода, nullptr - обход закончен
+    virtual TreeNode<T>* step(Stack& stack) = 0;
     virtual TreeTraversal<T>* clone() = 0;
     virtual ~TreeTraversal() = default;
+
+    void traverse(TreeNode<T>* root, std::vector<TreeNode<T>*>& result) {
+        Stack stack;
+        start(root, stack);
+        while (TreeNode<T>* node = step(stack)) {
+            result.push_back(node);
+        }
+    }
 };
 
 template <typename T>
 class InOrderTraversal : public TreeTraversal<T> {
+    using Stack = typename TreeTraversal<T>::Stack;
+
+    static void push_left(TreeNode<T>* node, Stack& stack) {
+        while (node) {
+            stack.push_back(node);
+            node = node->left;
+        }
+    }
+
 public:
-    void traverse(TreeNode<T>* node, std::vector<TreeNode<T>*>& result) override {
-        if (!node) return;
-        traverse(node->left, result);
-        result.push_back(node);
-        traverse(node->right, result);
+    void start(TreeNode<T>* root, Stack& stack) override {
+        push_left(root, stack);
+    }
+
+    TreeNode<T>* step(Stack& stack) override {
+        if (stack.empty()) return nullptr;
+        TreeNode<T>* node = stack.back();
+        stack.pop_back();
+        push_left(node->right, stack);
+        return node;
     }
 
     TreeTraversal<T>* clone() override {
@@ -28,12 +57,20 @@ public:
 
 template <typename T>
 class PreOrderTraversal : public TreeTraversal<T> {
+    using Stack = typename TreeTraversal<T>::Stack;
+
 public:
-    void traverse(TreeNode<T>* node, std::vector<TreeNode<T>*>& result) override {
-        if (!node) return;
-        result.push_back(node);
-        traverse(node->left, result);
-        traverse(node->right, result);
+    void start(TreeNode<T>* root, Stack& stack) override {
+        if (root) stack.push_back(root);
+    }
+
+    TreeNode<T>* step(Stack& stack) override {
+        if (stack.empty()) return nullptr;
+        TreeNode<T>* node = stack.back();
+        stack.pop_back();
+        if (node->right) stack.push_back(node->right);
+        if (node->left) stack.push_back(node->left);
+        return node;
     }
 
     TreeTraversal<T>* clone() override {
@@ -43,12 +80,31 @@ public:
 
 template <typename T>
 class PostOrderTraversal : public TreeTraversal<T> {
+    using Stack = typename TreeTraversal<T>::Stack;
+
+    // спуск к первому в обратном порядке листу поддерева
+    static void push_first_leaf(TreeNode<T>* node, Stack& stack) {
+        while (node) {
+            stack.push_back(node);
+            node = node->left ? node->left : node->right;
+        }
+    }
+
 public:
-    void traverse(TreeNode<T>* node, std::vector<TreeNode<T>*>& result) override {
-        if (!node) return;
-        traverse(node->left, result);
-        traverse(node->right, result);
-        result.push_back(node);
+    void start(TreeNode<T>* root, Stack& stack) override {
+        push_first_leaf(root, stack);
+    }
+
+    TreeNode<T>* step(Stack& stack) override {
+        if (stack.empty()) return nullptr;
+        TreeNode<T>* node = stack.back();
+        stack.pop_back();
+
+        // вышли из левого поддерева - дальше правое
+        if (!stack.empty() && stack.back()->left == node) {
+            push_first_leaf(stack.back()->right, stack);
+        }
+        return node;
     }
 
     TreeTraversal<T>* clone() override {
@@ -1,45 +1,90 @@
 #pragma once
+#include <stdexcept>
+#include <vector>
 #include "Traversal.hpp"
 #include "TreeNode.hpp"
+#include "UniquePtr.hpp"
 
 template<typename T>
 class TreeTraversal;
 
+// Ленивый итератор: узлы выдаются по одному по мере обхода,
+// в памяти только стек текущей ветки
 template <typename T>
 class TreeIterator {
-    std::vector<TreeNode<T>*> nodes;
-    size_t index = 0;
+    using Stack = std::vector<TreeNode<T>*>;
+
+    TreeNode<T>* root;
+    Unique_Ptr<TreeTraversal<T>> traversal; // своя копия, дерево может сменить обход
+    Stack stack;
+    TreeNode<T>* current;
+
+    size_t size;
+    bool size_known;
+
+    TreeNode<T>* node_at(size_t idx) const {
+        Stack path;
+        traversal->start(root, path);
+        TreeNode<T>* node = traversal->step(path);
+        for (size_t i = 0; node && i < idx; i++) {
+            node = traversal->step(path);
+        }
+
+        if (!node) {
+            throw std::out_of_range("Index out of range");
+        }
+        return node;
+    }
 
 public:
-    TreeIterator(TreeNode<T>* root, TreeTraversal<T>* traversal) {
-        traversal->traverse(root, nodes);
+    TreeIterator(TreeNode<T>* root, TreeTraversal<T>* traversal)
+    : root(root), traversal(traversal->clone()), current(nullptr), size(0), size_known(false) {
+        reset();
     }
 
+    TreeIterator(const TreeIterator& other)
+    : root(other.root), traversal(other.traversal->clone()), stack(other.stack),
+      current(other.current), size(other.size), size_known(other.size_known) {}
+
+    TreeIterator(TreeIterator&& other) = default;
+
     bool has_next() const {
-        return index < nodes.size();
+        return current != nullptr;
     }
 
     T& next() {
-        return nodes[index++]->data;
+        if (!current) {
+            throw std::out_of_range("Iterator is exhausted");
+        }
+        TreeNode<T>* node = current;
+        current = traversal->step(stack);
+        return node->data;
     }
 
+    // число узлов считается одним проходом при первом запросе
     size_t get_size() {
-        return nodes.size();
+        if (!size_known) {
+            Stack path;
+            traversal->start(root, path);
+            size = 0;
+            while (traversal->step(path)) size++;
+            size_known = true;
+        }
+        return size;
     }
 
+    // O(idx): обход с начала
     T& get_at(size_t idx) {
-        if (idx >= nodes.size()) {
-            throw std::out_of_range("Index out of range");
-        }
-        return nodes[idx]->data;
+        return node_at(idx)->data;
     }
 
     const T& get_at(size_t idx) const {
-        if (idx >= nodes.size()) {
-            throw std::out_of_range("Index out of range");
-        }
-        return nodes[idx]->data;
+        return node_at(idx)->data;
     }
 
-    void reset() { index = 0; }
+    void reset() {
+        stack.clear();
+        traversal->start(root, stack);
+        current = traversal->step(stack);
+    }
 };
@@ -6,7 +6,8 @@ struct TreeNode
     T data;
     TreeNode* left;
     TreeNode* right;
+    int height; // высота поддерева, лист - 1
     
     TreeNode(T new_value, TreeNode* new_left = nullptr, TreeNode* new_right = nullptr)
-    : data(new_value), left(new_left), right(new_right) {}
+    : data(new_value), left(new_left), right(new_right), height(1) {}
 };
\ No newline at end of file
@@ -0,0 +1,272 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "ReadOnlyStream.hpp"
+#include "UniquePtr.hpp"
+
+// Ограниченная очередь без блокировок для нескольких писателей и читателей.
+// Каждая ячейка хранит номер хода: писатель ждёт sequence == pos,
+// читатель ждёт sequence == pos + 1, после чтения ячейка сдвигается на круг вперёд.
+// Поток закончен, когда канал закрыт и все начатые записи разобраны.
+// Ожидающие сначала крутятся, потом засыпают на условной переменной;
+// будят их только если кто-то действительно спит.
+template <typename T>
+class Channel_Stream : public Read_Only_Stream<T>
+{
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    static constexpr size_t cache_line = 64;
+
+    Unique_Ptr<Slot[]> slots;
+    size_t mask;
+
+    alignas(cache_line) std::atomic<size_t> enqueue_pos;
+    alignas(cache_line) std::atomic<size_t> dequeue_pos;
+    alignas(cache_line) std::atomic<size_t> pending_pushes; // записи, начатые до закрытия
+    std::atomic<bool> closed;
+
+    // ожидание нужно и в константном is_end_of_stream
+    alignas(cache_line) mutable std::mutex sleep_mutex;
+    mutable std::condition_variable readable;
+    mutable std::condition_variable writable;
+    mutable std::atomic<size_t> sleeping_readers;
+    mutable std::atomic<size_t> sleeping_writers;
+
+private:
+    static size_t round_up(size_t capacity) {
+        size_t result = 2;
+        while (result < capacity) result <<= 1;
+        return result;
+    }
+
+    // сначала на месте, потом уступаем процессор; false - пора засыпать
+    static bool backoff(unsigned& spins) {
+        ++spins;
+        if (spins < 64) return true;
+        if (spins < 128) {
+            std::this_thread::yield();
+            return true;
+        }
+        return false;
+    }
+
+    // проверка спящих после fence парная их fetch_add перед проверкой условия
+    void wake(std::condition_variable& condition, std::atomic<size_t>& sleeping) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load() == 0) return;
+
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        condition.notify_all();
+    }
+
+    template <typename Predicate>
+    void sleep(std::condition_variable& condition, std::atomic<size_t>& sleeping, Predicate ready) const {
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleeping.fetch_add(1);
+        condition.wait(lock, ready);
+        sleeping.fetch_sub(1);
+    }
+
+    bool is_full() const {
+        return enqueue_pos.load() - dequeue_pos.load() > mask;
+    }
+
+    bool is_finished() const {
+        return closed.load() && pending_pushes.load() == 0 && is_empty();
+    }
+
+    // захватывает до n подряд идущих ячеек одним CAS
+    size_t claim(std::atomic<size_t>& cursor, size_t ready_shift, size_t n, size_t& start) {
+        size_t pos = cursor.load(std::memory_order_relaxed);
+        while (true) {
+            size_t count = 0;
+            while (count < n) {
+                size_t seq = slots[(pos + count) & mask].sequence.load(std::memory_order_acquire);
+                if (seq != pos + count + ready_shift) break;
+                count++;
+            }
+
+            if (count == 0) {
+                size_t seq = slots[pos & mask].sequence.load(std::memory_order_acquire);
+                if ((intptr_t)seq - (intptr_t)(pos + ready_shift) < 0) return 0;
+                pos = cursor.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (cursor.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                start = pos;
+                return count;
+            }
+        }
+    }
+
+    bool is_empty() const {
+        return dequeue_pos.load() >= enqueue_pos.load();
+    }
+
+    // головная ячейка опубликована, та же проверка, что в try_pop;
+    // по позициям нельзя: писатель мог занять ячейку, но ещё не записать
+    bool has_ready() const {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        return slots[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+public:
+    explicit Channel_Stream(size_t capacity = 1024)
+        : slots(nullptr), mask(0), enqueue_pos(0), dequeue_pos(0), pending_pushes(0), closed(false),
+          sleeping_readers(0), sleeping_writers(0)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("Channel capacity must be positive");
+
+        size_t size = round_up(capacity);
+        slots = Unique_Ptr<Slot[]>(new Slot[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    Channel_Stream(const Channel_Stream&) = delete;
+    Channel_Stream& operator=(const Channel_Stream&) = delete;
+
+    // пишет сколько поместилось, 0 если очередь полна
+    size_t try_push(const T* items, size_t n) {
+        pending_pushes.fetch_add(1);
+        if (closed.load()) {
+            pending_pushes.fetch_sub(1);
+            throw std::runtime_error("Push to closed channel");
+        }
+
+        size_t start = 0;
+        size_t count = n == 0 ? 0 : claim(enqueue_pos, 0, n, start);
+        for (size_t i = 0; i < count; i++) {
+            Slot& slot = slots[(start + i) & mask];
+            slot.item = items[i];
+            slot.sequence.store(start + i + 1, std::memory_order_release);
+        }
+
+        pending_pushes.fetch_sub(1);
+        wake(readable, sleeping_readers);
+        return count;
+    }
+
+    bool try_push(const T& item) {
+        return try_push(&item, 1) == 1;
+    }
+
+    // ждёт свободного места, пока не запишет всё
+    void push(const T* items, size_t n) {
+        unsigned spins = 0;
+        while (n > 0) {
+            size_t count = try_push(items, n);
+            if (count == 0) {
+                if (!backoff(spins))
+                    sleep(writable, sleeping_writers, [this] { return !is_full() || closed.load(); });
+                continue;
+            }
+            items += count;
+            n -= count;
+            spins = 0;
+        }
+    }
+
+    void push(const T& item) {
+        this->push(&item, 1);
+    }
+
+    // читает сколько готово, 0 если очередь пуста
+    size_t try_pop(T* out, size_t n) {
+        size_t start = 0;
+        size_t count = n == 0 ? 0 : claim(dequeue_pos, 1, n, start);
+        for (size_t i = 0; i < count; i++) {
+            Slot& slot = slots[(start + i) & mask];
+            out[i] = std::move(slot.item);
+            slot.sequence.store(start + i + mask + 1, std::memory_order_release);
+        }
+
+        if (count > 0) wake(writable, sleeping_writers);
+        return count;
+    }
+
+    bool try_pop(T& out) {
+        return try_pop(&out, 1) == 1;
+    }
+
+    // после закрытия новые записи бросают исключение, оставшиеся можно дочитать
+    void close() {
+        closed.store(true);
+        wake(readable, sleeping_readers);
+        wake(writable, sleeping_writers);
+    }
+
+    bool is_closed() const {
+        return closed.load();
+    }
+
+    // ждёт, пока появится элемент или канал закроется пустым
+    bool is_end_of_stream() const override {
+        unsigned spins = 0;
+        while (true) {
+            if (has_ready()) return false;
+            if (is_finished()) return true;
+            if (!backoff(spins))
+                sleep(readable, sleeping_readers, [this] { return has_ready() || is_finished(); });
+        }
+    }
+
+    bool is_can_seek() const override {
+        return false;
+    }
+
+    bool seek(size_t) override {
+        return false;
+    }
+
+    T read() override {
+        T item;
+        if (this->read(&item, 1) == 0)
+            throw std::runtime_error("End of stream reached");
+        return item;
+    }
+
+    // ждёт хотя бы один элемент, дальше забирает только готовые;
+    // 0 - канал закрыт и пуст
+    size_t read(T* out, size_t n) override {
+        if (n == 0) return 0;
+
+        unsigned spins = 0;
+        while (true) {
+            size_t count = try_pop(out, n);
+            if (count > 0) return count;
+            if (is_finished()) return 0;
+            if (!backoff(spins))
+                sleep(readable, sleeping_readers, [this] { return has_ready() || is_finished(); });
+        }
+    }
+
+    void reset() override {
+        throw std::runtime_error("Channel can't be reset");
+    }
+
+    // сколько элементов забрано всеми читателями
+    size_t get_position() const override {
+        return dequeue_pos.load();
+    }
+
+    // сколько элементов записано всеми писателями
+    size_t get_size() const override {
+        return enqueue_pos.load();
+    }
+
+    size_t get_capacity() const {
+        return mask + 1;
+    }
+};
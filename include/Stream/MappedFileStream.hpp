@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "ReadOnlyStream.hpp"
+#include "MappedFile.hpp"
+
+// поток по бинарному файлу из элементов T, файл отображается в память целиком
+template <typename T>
+class Mapped_File_Stream : public Read_Only_Stream<T>
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Mapped_File_Stream requires trivially copyable T");
+
+private:
+    Mapped_File file;
+    size_t count;
+    size_t position;
+
+public:
+    Mapped_File_Stream(const std::string& path)
+        : file(path), count(0), position(0)
+    {
+        if (file.get_size() % sizeof(T) != 0)
+            throw std::runtime_error("File size is not a multiple of element size");
+
+        count = file.get_size() / sizeof(T);
+    }
+
+    ~Mapped_File_Stream() {}
+
+    bool is_end_of_stream() const override {
+        return position >= count;
+    }
+
+    bool is_can_seek() const override {
+        return true;
+    }
+
+    bool seek(size_t index) override {
+        if (index > count)
+            throw std::runtime_error("Index beyond end of file");
+
+        position = index;
+        return true;
+    }
+
+    T read() override {
+        if (this->is_end_of_stream())
+            throw std::runtime_error("End of stream reached");
+
+        T item;
+        std::memcpy(&item, file.get_data() + position * sizeof(T), sizeof(T));
+        position++;
+        return item;
+    }
+
+    size_t read(T* out, size_t n) override {
+        size_t count = std::min(n, this->count - position);
+        if (count == 0) return 0; // у пустого файла нет отображения
+
+        std::memcpy(out, file.get_data() + position * sizeof(T), count * sizeof(T));
+        position += count;
+        return count;
+    }
+
+    Stream_View<T> read_view(size_t n) override {
+        Stream_View<T> view;
+        view.data = this->get_data() + position;
+        view.size = std::min(n, this->count - position);
+        position += view.size;
+        return view;
+    }
+
+    void reset() override {
+        position = 0;
+    }
+
+    size_t get_position() const override {
+        return position;
+    }
+
+    size_t get_size() const override {
+        return count;
+    }
+
+    // отображение выровнено по странице, элементы можно читать напрямую
+    const T* get_data() const {
+        return reinterpret_cast<const T*>(file.get_data());
+    }
+};
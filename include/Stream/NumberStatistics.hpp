@@ -1,38 +1,208 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "LazySequence.hpp"
+#include "ArraySequence.hpp"
+#include "ReadOnlyStream.hpp"
+#include "StatisticsKernels.hpp"
 
+// Тип, в котором копится сумма: целые расширяются до 64 или 128 бит,
+// вещественные суммируются с компенсацией ошибки округления (Ноймайер).
+// result - тип, которым сумма отдаётся наружу: 128 бит остаются внутри
+template <typename T, typename = void>
+struct Statistics_Accumulator {
+    using type = double;
+    using result = double;
+    static constexpr bool compensated = true;
+};
+
+template <typename T>
+struct Statistics_Accumulator<T, std::enable_if_t<std::is_integral_v<T>>> {
+    using wide = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+    using widest = std::conditional_t<std::is_signed_v<T>, __int128, unsigned __int128>;
+
+    using type = std::conditional_t<(sizeof(T) < sizeof(int64_t)), wide, widest>;
+    using result = wide;
+    static constexpr bool compensated = false;
+};
+
+template <>
+struct Statistics_Accumulator<long double> {
+    using type = long double;
+    using result = long double;
+    static constexpr bool compensated = true;
+};
+
+// Среднее и дисперсия считаются онлайн по Уэлфорду, частичные результаты
+// объединяются точно по формулам Чана, поэтому куски потока можно считать параллельно.
 template <typename T>
 class Number_Statistics {
+public:
+    using accumulator_type = typename Statistics_Accumulator<T>::type;
+    using sum_type = typename Statistics_Accumulator<T>::result;
+
 private:
+    static constexpr bool compensated = Statistics_Accumulator<T>::compensated;
+
+    // блок пакетной обработки помещается в L1, второй проход по нему почти бесплатный
+    static constexpr size_t batch_block = 2048;
+
     size_t count = 0;
-    T sum = 0;
-    T min_val;
-    T max_val;
-    bool initialized = false;
+    accumulator_type sum = 0;
+    accumulator_type compensation = 0; // потерянные младшие разряды суммы
+
+    double mean = 0.0;
+    double m2 = 0.0; // сумма квадратов отклонений от среднего
+
+    T min_val = T();
+    T max_val = T();
+
+private:
+    void add_to_sum(accumulator_type value) {
+        if constexpr (compensated) {
+            accumulator_type total = sum + value;
+            if (std::abs(sum) >= std::abs(value)) compensation += (sum - total) + value;
+            else compensation += (value - total) + sum;
+            sum = total;
+        } else {
+            sum += value;
+        }
+    }
+
+    void check_not_empty() const {
+        if (count == 0)
+            throw std::runtime_error("Cannot calculate statistics: no elements");
+    }
+
+    void merge_part(size_t other_count, accumulator_type other_sum, double other_mean, double other_m2,
+        const T& other_min, const T& other_max)
+    {
+        if (count == 0) {
+            min_val = other_min;
+            max_val = other_max;
+        } else {
+            if (other_min < min_val) min_val = other_min;
+            if (other_max > max_val) max_val = other_max;
+        }
+
+        add_to_sum(other_sum);
+
+        double total = static_cast<double>(count + other_count);
+        double delta = other_mean - mean;
+        mean += delta * other_count / total;
+        m2 += other_m2 + delta * delta * count * other_count / total;
+        count += other_count;
+    }
 
 public:
     void consume(const T& value) {
-        if (!initialized) {
+        if (count == 0) {
             min_val = max_val = value;
-            initialized = true;
         } else {
             if (value < min_val) min_val = value;
             if (value > max_val) max_val = value;
         }
 
-        sum += value;
+        add_to_sum(static_cast<accumulator_type>(value));
         ++count;
+
+        double delta = static_cast<double>(value) - mean;
+        mean += delta / count;
+        m2 += delta * (static_cast<double>(value) - mean);
+    }
+
+    // для int - векторные ядра по блокам, для остальных типов - поэлементно
+    void consume_batch(const T* data, size_t n) {
+        if constexpr (std::is_same_v<T, int>) {
+            for (size_t from = 0; from < n; from += batch_block) {
+                size_t size = std::min(batch_block, n - from);
+                Int_Block_Summary block = summarize_int_block(data + from, size);
+                merge_part(size, block.sum, (double)block.sum / size, block.m2, block.min, block.max);
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) consume(data[i]);
+        }
+    }
+
+    void consume_batch(Stream_View<T> view) {
+        consume_batch(view.data, view.size);
+    }
+
+    void consume_batch(const Array_Sequence<T>& sequence) {
+        if (sequence.get_size() == 0) return;
+        consume_batch(&sequence.get(0), sequence.get_size());
+    }
+
+    void merge(const Number_Statistics& other) {
+        if (other.count == 0) return;
+
+        merge_part(other.count, other.sum, other.mean, other.m2, other.min_val, other.max_val);
+        if constexpr (compensated) compensation += other.compensation;
     }
 
     size_t get_count() const { return count; }
 
-    T get_sum() const { return sum; }
+    // сумма целых не поместилась в 64 бита, точно её отдаёт только get_sum_approx
+    bool is_sum_overflowed() const {
+        if constexpr (compensated) {
+            return false;
+        } else {
+            return sum > (accumulator_type)std::numeric_limits<sum_type>::max() ||
+                   sum < (accumulator_type)std::numeric_limits<sum_type>::min();
+        }
+    }
+
+    sum_type get_sum() const {
+        if (is_sum_overflowed())
+            throw std::overflow_error("Sum doesn't fit in 64 bits");
+        return static_cast<sum_type>(sum + compensation);
+    }
+
+    long double get_sum_approx() const {
+        return static_cast<long double>(sum) + static_cast<long double>(compensation);
+    }
+
+    double get_mean() const {
+        check_not_empty();
+
+        // у целых сумма точная, среднее по ней не накапливает ошибку
+        if constexpr (!compensated) return static_cast<double>(sum) / count;
+        return mean;
+    }
+
+    // дисперсия генеральной совокупности
+    double get_variance() const {
+        check_not_empty();
+        return m2 / count;
+    }
+
+    // несмещённая выборочная дисперсия
+    double get_sample_variance() const {
+        if (count < 2)
+            throw std::runtime_error("Cannot calculate sample variance: less than two elements");
+        return m2 / (count - 1);
+    }
 
-    double get_mean() const { //медиана
-        return count == 0 ? 0.0 : (double)sum / count;
+    double get_stddev() const {
+        return std::sqrt(get_variance());
     }
 
-    T get_min() const { return min_val; }
+    T get_min() const {
+        check_not_empty();
+        return min_val;
+    }
 
-    T get_max() const { return max_val; }
+    T get_max() const {
+        check_not_empty();
+        return max_val;
+    }
+
+    void clear() {
+        *this = Number_Statistics();
+    }
 
 };
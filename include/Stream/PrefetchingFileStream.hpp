@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "ReadOnlyStream.hpp"
+#include "PrefetchingReader.hpp"
+
+// поток по бинарному файлу из элементов T, который не обязан помещаться в память:
+// блоки читаются заранее в фоновом потоке, в памяти лежат только buffer_count блоков
+template <typename T>
+class Prefetching_File_Stream : public Read_Only_Stream<T>
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Prefetching_File_Stream requires trivially copyable T");
+
+private:
+    // блок из целого числа элементов и кратен выравниванию
+    static constexpr size_t block_granularity = Prefetching_Reader::alignment;
+
+    size_t block_elements;
+    Prefetching_Reader reader;
+    size_t count;
+
+    const char* block;
+    size_t block_begin;
+    size_t block_end;
+    size_t pending_skip; // после seek часть первого блока пропускается
+
+    size_t position;
+
+private:
+    static size_t round_block(size_t elements) {
+        if (elements == 0)
+            throw std::invalid_argument("Block size must be positive");
+
+        return (elements + block_granularity - 1) / block_granularity * block_granularity;
+    }
+
+    bool next_block() {
+        if (block) reader.release();
+
+        size_t size = 0;
+        block = reader.acquire(size);
+        block_begin = pending_skip;
+        block_end = size / sizeof(T);
+        pending_skip = 0;
+
+        return block && block_begin < block_end;
+    }
+
+    const T* current() const {
+        return reinterpret_cast<const T*>(block) + block_begin;
+    }
+
+public:
+    Prefetching_File_Stream(const std::string& path, size_t block_elements = 1 << 16,
+        size_t buffer_count = 2, bool direct = false)
+        : block_elements(round_block(block_elements)),
+          reader(path, this->block_elements * sizeof(T), buffer_count, direct),
+          count(0), block(nullptr), block_begin(0), block_end(0), pending_skip(0), position(0)
+    {
+        if (reader.get_file_size() % sizeof(T) != 0)
+            throw std::runtime_error("File size is not a multiple of element size");
+
+        count = reader.get_file_size() / sizeof(T);
+    }
+
+    Prefetching_File_Stream(const Prefetching_File_Stream&) = delete;
+    Prefetching_File_Stream& operator=(const Prefetching_File_Stream&) = delete;
+
+    bool is_end_of_stream() const override {
+        return position >= count;
+    }
+
+    bool is_can_seek() const override {
+        return true;
+    }
+
+    // чтение перезапускается с блока, содержащего index
+    bool seek(size_t index) override {
+        if (index > count)
+            throw std::runtime_error("Index beyond end of file");
+
+        size_t block_index = index / block_elements;
+        reader.restart(block_index * block_elements * sizeof(T));
+
+        block = nullptr;
+        block_begin = block_end = 0;
+        pending_skip = index - block_index * block_elements;
+        position = index;
+        return true;
+    }
+
+    T read() override {
+        T item;
+        if (this->read(&item, 1) == 0)
+            throw std::runtime_error("End of stream reached");
+        return item;
+    }
+
+    size_t read(T* out, size_t n) override {
+        size_t done = 0;
+        while (done < n && position < count) {
+            if (block_begin == block_end && !next_block()) break;
+
+            size_t available = std::min(n - done, block_end - block_begin);
+            std::memcpy(out + done, current(), available * sizeof(T));
+
+            block_begin += available;
+            position += available;
+            done += available;
+        }
+        return done;
+    }
+
+    // вид не выходит за границу блока
+    Stream_View<T> read_view(size_t n) override {
+        if (position >= count) return Stream_View<T>();
+        if (block_begin == block_end && !next_block()) return Stream_View<T>();
+
+        Stream_View<T> view;
+        view.data = current();
+        view.size = std::min(n, block_end - block_begin);
+
+        block_begin += view.size;
+        position += view.size;
+        return view;
+    }
+
+    void reset() override {
+        this->seek(0);
+    }
+
+    size_t get_position() const override {
+        return position;
+    }
+
+    size_t get_size() const override {
+        return count;
+    }
+
+    bool is_direct() const {
+        return reader.is_direct();
+    }
+};
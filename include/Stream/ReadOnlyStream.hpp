@@ -3,14 +3,33 @@
 #include "Sequence.hpp"
 #include "LazySequence.hpp"
 #include "SharedPtr.hpp"
+#include "UniquePtr.hpp"
+#include "PipelineProfiler.hpp"
+#include <algorithm>
 #include <exception>
+#include <limits>
+#include <vector>
 
 template <typename T>
 class Lazy_Sequence;
 
+// элементы, одолженные из внутреннего буфера потока
+template <typename T>
+struct Stream_View {
+    const T* data = nullptr;
+    size_t size = 0;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
 template <typename T>
 class Read_Only_Stream {
 public:
+    // get_size потока, длина которого заранее неизвестна
+    static constexpr size_t unknown_size = std::numeric_limits<size_t>::max();
+
     virtual ~Read_Only_Stream() = default;
 
     virtual bool is_end_of_stream() const = 0;
@@ -19,13 +38,61 @@ public:
 
     virtual T read() = 0;
 
+    // читает до n элементов, меньше только в конце потока
+    virtual size_t read(T* out, size_t n) {
+        size_t count = 0;
+        while (count < n && !this->is_end_of_stream()) {
+            out[count++] = this->read();
+        }
+        return count;
+    }
+
+    // до n элементов без копирования, пустой вид если поток так не умеет;
+    // вид действителен до следующего обращения к потоку
+    virtual Stream_View<T> read_view(size_t) {
+        return Stream_View<T>();
+    }
+
     virtual void reset() = 0;
 
     virtual size_t get_position() const = 0;
     virtual size_t get_size() const = 0;
+
+    virtual void get_upstream(std::vector<const Pipeline_Node*>&) const {}
 };
 
 
+// отдаёт до limit элементов потока блоками в func(data, size):
+// без копирования, если поток умеет read_view, иначе через буфер в куче,
+// который выделяется один раз при первой надобности
+template <typename T, typename Func>
+size_t read_in_batches(Read_Only_Stream<T>& stream, size_t limit, Func func)
+{
+    constexpr size_t batch_size = 4096;
+    Unique_Ptr<T[]> batch;
+
+    size_t total = 0;
+    while (total < limit && !stream.is_end_of_stream()) {
+        size_t wanted = std::min(batch_size, limit - total);
+
+        Stream_View<T> view = stream.read_view(wanted);
+        if (!view.empty()) {
+            func(view.data, view.size);
+            total += view.size;
+            continue;
+        }
+
+        if (!batch.get()) batch = Unique_Ptr<T[]>(new T[batch_size]);
+        size_t count = stream.read(batch.get(), wanted);
+        if (count == 0) break;
+
+        func(static_cast<const T*>(batch.get()), count);
+        total += count;
+    }
+    return total;
+}
+
+
 //сделать генератор в lazy_seq который хранит Unique_Ptr<Read_Only_Stream>
 // в котором будет находиться lazy_Seq
 // и потом обрабатывать как статистику элементы с lazy_seq который создан от такого генератора
@@ -35,6 +102,22 @@ class Lazy_Read_Only_Stream : public Read_Only_Stream<T> //генератор к
 private:
     Shared_Ptr<Lazy_Sequence<T>> lazy_sequence;
     size_t position;
+    std::exception_ptr pending_error; // ошибка после частичного чтения, бросается следующим вызовом
+
+private:
+    void rethrow_pending() {
+        if (!pending_error) return;
+        std::exception_ptr error = pending_error;
+        pending_error = nullptr;
+        std::rethrow_exception(error);
+    }
+
+    // после перехода за материализованный префикс элементы не материализуются
+    T fetch(size_t index) {
+        if (index > lazy_sequence->get_materialized_count())
+            return lazy_sequence->peek(index);
+        return lazy_sequence->get(index);
+    }
 
 public:
 
@@ -44,7 +127,8 @@ public:
         : lazy_sequence(lazy_seq), position(0) {}
 
     bool is_end_of_stream() const override {
-        return !lazy_sequence->has_next();
+        if (pending_error) return false;
+        return !lazy_sequence->has_at(position);
     }
 
     bool is_can_seek() const override {
@@ -52,21 +136,59 @@ public:
     }
 
     T read() {
-        return lazy_sequence->get(position++);
+        rethrow_pending();
+        return fetch(position++);
+    }
+
+    // прочитанное до ошибки отдаётся, сама ошибка - при следующем чтении
+    size_t read(T* out, size_t n) override {
+        rethrow_pending();
+
+        size_t count = 0;
+        try {
+            while (count < n && lazy_sequence->has_at(position)) {
+                out[count++] = fetch(position);
+                position++;
+            }
+        } catch (...) {
+            if (count == 0) throw;
+            pending_error = std::current_exception();
+        }
+        return count;
     }
 
+    Stream_View<T> read_view(size_t n) override {
+        rethrow_pending();
+
+        if (lazy_sequence->is_compressed() || position > lazy_sequence->get_materialized_count())
+            return Stream_View<T>();
+
+        // материализовано может быть больше, чем просили
+        size_t available = std::min(lazy_sequence->materialize_to(position + n), position + n);
+        if (available <= position) return Stream_View<T>();
+
+        Stream_View<T> view;
+        view.data = lazy_sequence->get_materialized_data() + position;
+        view.size = available - position;
+        position = available;
+        return view;
+    }
+
+    // index может указывать на конец последовательности
     bool seek(size_t index) override { 
         if (!this->is_can_seek()) return false; 
 
-        if (index < 0 || index >= lazy_sequence->get_materialized_count()) 
-            throw std::runtime_error("Index beyond matrialized data");
+        if (index > 0 && !lazy_sequence->has_at(index - 1)) 
+            throw std::runtime_error("Index beyond possible generation");
 
         position = index;
+        pending_error = nullptr;
         return true; 
     }
 
     void reset() override {
         position = 0;
+        pending_error = nullptr;
     }
 
     size_t get_position() const override {
@@ -77,6 +199,10 @@ public:
         return lazy_sequence->get_materialized_count();
     }
 
+    void get_upstream(std::vector<const Pipeline_Node*>& result) const override {
+        result.push_back(lazy_sequence.get());
+    }
+
 };
 
 // template <typename T>
@@ -0,0 +1,210 @@
+#pragma once
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+#include "ReadOnlyStream.hpp"
+#include "SharedPtr.hpp"
+#include "UniquePtr.hpp"
+#include "EnableSharedFromThis.hpp"
+
+template <typename T>
+class Tee_Cursor;
+
+// Раздаёт N независимых курсоров по одному источнику.
+// Буферизуется только участок между самым медленным и самым быстрым курсором:
+// блоки, пройденные всеми курсорами, освобождаются и используются повторно.
+template <typename T>
+class Tee_Stream : public Enable_Shared_From_This<Tee_Stream<T>>
+{
+private:
+    Shared_Ptr<Read_Only_Stream<T>> upstream;
+    size_t chunk_size;
+
+    std::deque<Unique_Ptr<T[]>> chunks;      // chunks[i] начинается с first_index + i * chunk_size
+    std::vector<Unique_Ptr<T[]>> free_chunks;
+    size_t first_index;
+    size_t end_index;                        // сколько элементов прочитано из источника
+
+    std::vector<size_t> positions;
+    std::vector<bool> active;
+    std::vector<bool> handed_out;
+
+private:
+    Tee_Stream(Shared_Ptr<Read_Only_Stream<T>> upstream, size_t cursors, size_t chunk_size)
+        : upstream(upstream), chunk_size(chunk_size), first_index(0), end_index(0),
+          positions(cursors, 0), active(cursors, true), handed_out(cursors, false) {}
+
+    // дочитывает источник, пока index не окажется в буфере
+    bool fill_to(size_t index) {
+        while (end_index <= index) {
+            if (upstream->is_end_of_stream()) return false;
+
+            size_t offset = end_index - first_index;
+            if (offset == chunks.size() * chunk_size) {
+                if (!free_chunks.empty()) {
+                    chunks.push_back(std::move(free_chunks.back()));
+                    free_chunks.pop_back();
+                } else {
+                    chunks.push_back(Unique_Ptr<T[]>(new T[chunk_size]));
+                }
+            }
+
+            T* chunk = chunks.back().get();
+            size_t in_chunk = offset % chunk_size;
+            size_t count = upstream->read(chunk + in_chunk, chunk_size - in_chunk);
+            if (count == 0) return false;
+
+            end_index += count;
+        }
+        return true;
+    }
+
+    const T* locate(size_t index, size_t& available) const {
+        size_t offset = index - first_index;
+        size_t in_chunk = offset % chunk_size;
+        available = std::min(chunk_size - in_chunk, end_index - index);
+        return chunks[offset / chunk_size].get() + in_chunk;
+    }
+
+    void release() {
+        size_t slowest = end_index;
+        for (size_t i = 0; i < positions.size(); i++) {
+            if (active[i]) slowest = std::min(slowest, positions[i]);
+        }
+
+        while (!chunks.empty() && first_index + chunk_size <= slowest) {
+            free_chunks.push_back(std::move(chunks.front()));
+            chunks.pop_front();
+            first_index += chunk_size;
+        }
+
+        // запас не больше одного блока
+        while (free_chunks.size() > 1) free_chunks.pop_back();
+    }
+
+    void move_cursor(size_t cursor, size_t position) {
+        positions[cursor] = position;
+        release();
+    }
+
+    void detach(size_t cursor) {
+        active[cursor] = false;
+        release();
+    }
+
+public:
+    static Shared_Ptr<Tee_Stream<T>> create(Shared_Ptr<Read_Only_Stream<T>> upstream,
+        size_t cursors, size_t chunk_size = 4096)
+    {
+        if (chunk_size == 0)
+            throw std::invalid_argument("Chunk size must be positive");
+
+        return Shared_Ptr<Tee_Stream<T>>(
+            new Tee_Stream<T>(upstream, cursors, chunk_size)
+        );
+    }
+
+    // каждый курсор выдаётся один раз, до выдачи он удерживает данные с начала
+    Shared_Ptr<Read_Only_Stream<T>> get_cursor(size_t cursor) {
+        if (cursor >= positions.size())
+            throw std::out_of_range("No such cursor");
+        if (handed_out[cursor])
+            throw std::runtime_error("Cursor already taken");
+
+        handed_out[cursor] = true;
+        return Shared_Ptr<Read_Only_Stream<T>>(new Tee_Cursor<T>(this->shared_from_this(), cursor));
+    }
+
+    size_t get_buffered_count() const {
+        return end_index - first_index;
+    }
+
+    size_t get_read_count() const {
+        return end_index;
+    }
+
+    friend class Tee_Cursor<T>;
+};
+
+
+template <typename T>
+class Tee_Cursor : public Read_Only_Stream<T>
+{
+private:
+    Shared_Ptr<Tee_Stream<T>> tee;
+    size_t cursor;
+    size_t position;
+
+public:
+    Tee_Cursor(Shared_Ptr<Tee_Stream<T>> tee, size_t cursor)
+        : tee(tee), cursor(cursor), position(0) {}
+
+    ~Tee_Cursor() {
+        tee->detach(cursor);
+    }
+
+    bool is_end_of_stream() const override {
+        return !tee->fill_to(position);
+    }
+
+    bool is_can_seek() const override {
+        return false;
+    }
+
+    bool seek(size_t) override {
+        return false;
+    }
+
+    T read() override {
+        if (!tee->fill_to(position))
+            throw std::runtime_error("End of stream reached");
+
+        size_t available = 0;
+        T item = *tee->locate(position, available);
+        tee->move_cursor(cursor, ++position);
+        return item;
+    }
+
+    size_t read(T* out, size_t n) override {
+        size_t count = 0;
+        while (count < n && tee->fill_to(position)) {
+            size_t available = 0;
+            const T* data = tee->locate(position, available);
+            available = std::min(available, n - count);
+
+            std::copy(data, data + available, out + count);
+            count += available;
+            position += available;
+        }
+
+        tee->move_cursor(cursor, position);
+        return count;
+    }
+
+    // вид не выходит за границу блока; блок удерживается до следующего обращения
+    Stream_View<T> read_view(size_t n) override {
+        tee->move_cursor(cursor, position);
+        if (n == 0 || !tee->fill_to(position)) return Stream_View<T>();
+
+        Stream_View<T> view;
+        size_t available = 0;
+        view.data = tee->locate(position, available);
+        view.size = std::min(available, n);
+
+        position += view.size;
+        return view;
+    }
+
+    void reset() override {
+        throw std::runtime_error("Tee cursor can't be reset");
+    }
+
+    size_t get_position() const override {
+        return position;
+    }
+
+    size_t get_size() const override {
+        return tee->get_read_count();
+    }
+};
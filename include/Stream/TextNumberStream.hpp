@@ -0,0 +1,171 @@
+#pragma once
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ReadOnlyStream.hpp"
+#include "UniquePtr.hpp"
+
+// поток чисел, разделённых пробелами или переводами строк, из файла или дескриптора
+template <typename T>
+class Text_Number_Stream : public Read_Only_Stream<T>
+{
+private:
+    static constexpr size_t buffer_size = 1 << 20;
+
+    int fd;
+    bool owns_fd;
+
+    // состояние буфера меняется при проверке конца потока
+    mutable Unique_Ptr<char[]> buffer;
+    mutable size_t begin;
+    mutable size_t end;
+    mutable bool input_finished;
+
+    size_t position;
+
+private:
+    static bool is_space(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // сдвигает непрочитанный хвост в начало и дочитывает буфер
+    bool refill() const {
+        if (input_finished) return false;
+
+        if (begin > 0) {
+            std::memmove(buffer.get(), buffer.get() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+        }
+
+        if (end == buffer_size)
+            throw std::runtime_error("Number is too long");
+
+        ssize_t count;
+        do {
+            count = ::read(fd, buffer.get() + end, buffer_size - end);
+        } while (count < 0 && errno == EINTR);
+
+        if (count < 0)
+            throw std::runtime_error("Cannot read text stream");
+
+        if (count == 0) {
+            input_finished = true;
+            return false;
+        }
+
+        end += count;
+        return true;
+    }
+
+    // пропускает разделители, true если впереди есть число
+    bool skip_spaces() const {
+        while (true) {
+            while (begin < end && is_space(buffer[begin])) begin++;
+            if (begin < end) return true;
+            if (!refill()) return false;
+        }
+    }
+
+    T parse_next() {
+        if (!skip_spaces())
+            throw std::runtime_error("End of stream reached");
+
+        // число должно целиком лежать в буфере
+        size_t token_end = begin;
+        while (true) {
+            while (token_end < end && !is_space(buffer[token_end])) token_end++;
+            if (token_end < end || input_finished) break;
+
+            size_t offset = token_end - begin;
+            if (!refill()) {
+                token_end = begin + offset;
+                break;
+            }
+            token_end = begin + offset;
+        }
+
+        T value;
+        const char* first = buffer.get() + begin;
+        const char* last = buffer.get() + token_end;
+        auto [ptr, error] = std::from_chars(first, last, value);
+
+        if (error != std::errc() || ptr != last)
+            throw std::runtime_error("Invalid number: " + std::string(first, last));
+
+        begin = token_end;
+        position++;
+        return value;
+    }
+
+public:
+    explicit Text_Number_Stream(const std::string& path)
+        : fd(::open(path.c_str(), O_RDONLY)), owns_fd(true),
+          buffer(new char[buffer_size]),
+          begin(0), end(0), input_finished(false), position(0)
+    {
+        if (fd < 0)
+            throw std::runtime_error("Cannot open file: " + path);
+
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    // дескриптор не закрывается, например STDIN_FILENO
+    explicit Text_Number_Stream(int descriptor)
+        : fd(descriptor), owns_fd(false),
+          buffer(new char[buffer_size]),
+          begin(0), end(0), input_finished(false), position(0) {}
+
+    ~Text_Number_Stream() {
+        if (owns_fd) ::close(fd);
+    }
+
+    Text_Number_Stream(const Text_Number_Stream&) = delete;
+    Text_Number_Stream& operator=(const Text_Number_Stream&) = delete;
+
+    bool is_end_of_stream() const override {
+        return !skip_spaces();
+    }
+
+    bool is_can_seek() const override {
+        return false;
+    }
+
+    bool seek(size_t) override {
+        return false;
+    }
+
+    T read() override {
+        return parse_next();
+    }
+
+    size_t read(T* out, size_t n) override {
+        size_t count = 0;
+        while (count < n && skip_spaces()) {
+            out[count++] = parse_next();
+        }
+        return count;
+    }
+
+    void reset() override {
+        if (::lseek(fd, 0, SEEK_SET) != 0)
+            throw std::runtime_error("Text stream can't be reset");
+
+        begin = end = 0;
+        input_finished = false;
+        position = 0;
+    }
+
+    size_t get_position() const override {
+        return position;
+    }
+
+    // число значений известно только после разбора всего файла
+    size_t get_size() const override {
+        return Read_Only_Stream<T>::unknown_size;
+    }
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <charconv>
+#include <string>
+#include <type_traits>
+#include "BufferedFile.hpp"
+
+template <typename T>
+class Write_Only_Stream {
+public:
+    virtual ~Write_Only_Stream() = default;
+
+    virtual void write(const T& item) = 0;
+    virtual void write(const T* data, size_t n) = 0;
+
+    virtual void flush() = 0;
+
+    virtual size_t get_position() const = 0;
+};
+
+
+// элементы пишутся как есть, файл читается обратно через Mapped_File_Stream
+template <typename T>
+class Binary_File_Write_Stream : public Write_Only_Stream<T>
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Binary_File_Write_Stream requires trivially copyable T");
+
+private:
+    Buffered_File file;
+    size_t position;
+
+public:
+    Binary_File_Write_Stream(const std::string& path) : file(path), position(0) {}
+
+    void write(const T& item) override {
+        file.append(reinterpret_cast<const char*>(&item), sizeof(T));
+        position++;
+    }
+
+    void write(const T* data, size_t n) override {
+        file.append(reinterpret_cast<const char*>(data), n * sizeof(T));
+        position += n;
+    }
+
+    void flush() override {
+        file.flush();
+    }
+
+    size_t get_position() const override {
+        return position;
+    }
+};
+
+
+// по одному числу на строку, формат совместим с Text_Number_Stream
+template <typename T>
+class Text_Write_Stream : public Write_Only_Stream<T>
+{
+private:
+    static constexpr size_t max_item_length = 64;
+
+    Buffered_File file;
+    size_t position;
+
+private:
+    void format(const T& item) {
+        char* out = file.reserve(max_item_length);
+        auto [end, error] = std::to_chars(out, out + max_item_length - 1, item);
+        if (error != std::errc())
+            throw std::runtime_error("Cannot format value");
+
+        *end++ = '\n';
+        file.commit(end - out);
+    }
+
+public:
+    Text_Write_Stream(const std::string& path) : file(path), position(0) {}
+
+    Text_Write_Stream(int descriptor) : file(descriptor), position(0) {}
+
+    void write(const T& item) override {
+        format(item);
+        position++;
+    }
+
+    void write(const T* data, size_t n) override {
+        for (size_t i = 0; i < n; i++) {
+            format(data[i]);
+        }
+        position += n;
+    }
+
+    void flush() override {
+        file.flush();
+    }
+
+    size_t get_position() const override {
+        return position;
+    }
+};
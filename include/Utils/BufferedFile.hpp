@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "UniquePtr.hpp"
+
+// файл для записи с большим буфером, сбрасывается целыми блоками
+class Buffered_File {
+private:
+    static constexpr size_t buffer_size = 1 << 20;
+
+    int fd;
+    bool owns_fd;
+    Unique_Ptr<char[]> buffer;
+    size_t used;
+
+private:
+    void write_all(const char* data, size_t size);
+
+public:
+    explicit Buffered_File(const std::string& path);
+    explicit Buffered_File(int descriptor); // дескриптор не закрывается
+    ~Buffered_File();
+
+    Buffered_File(const Buffered_File&) = delete;
+    Buffered_File& operator=(const Buffered_File&) = delete;
+
+    void append(const char* data, size_t size);
+
+    // место под запись не меньше size байт, заполненная часть подтверждается commit
+    char* reserve(size_t size);
+    void commit(size_t size) { used += size; }
+
+    void flush();
+};
@@ -0,0 +1,246 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "LazySequence.hpp"
+#include "ReadOnlyStream.hpp"
+#include "SharedPtr.hpp"
+
+// Число различных значений потока (HyperLogLog++).
+// 64-битный хеш делится на номер регистра (старшие precision бит) и ранг -
+// позицию первой единицы в остатке; регистр хранит максимальный ранг.
+// Пока различных значений мало, вместо 2^precision регистров хранится
+// разреженный список пар (номер при точности 25 бит, ранг) - он точнее и меньше.
+// Относительная ошибка около 1.04 / sqrt(2^precision).
+template <typename T>
+class Distinct_Counter {
+private:
+    static constexpr unsigned sparse_precision = 25;
+    static constexpr unsigned rank_bits = 6;
+
+    unsigned precision;
+    size_t register_count;
+
+    bool sparse;
+    std::vector<uint32_t> sparse_list;   // отсортировано по номеру, номера уникальны
+    std::vector<uint32_t> sparse_buffer; // новые пары до слияния со списком
+    std::vector<uint8_t> registers;
+
+private:
+    static uint64_t hash_of(const T& value) {
+        uint64_t x = std::hash<T>()(value);
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // позиция первой единицы в старших 64 - bits битах после сдвига
+    static uint8_t rank_of(uint64_t hash, unsigned bits) {
+        uint64_t rest = hash << bits;
+        return rest == 0 ? (uint8_t)(64 - bits + 1) : (uint8_t)(__builtin_clzll(rest) + 1);
+    }
+
+    static uint32_t sparse_index(uint32_t entry) { return entry >> rank_bits; }
+
+    static uint8_t sparse_rank(uint32_t entry) { return entry & ((1u << rank_bits) - 1); }
+
+    // номер регистра и ранг при обычной точности по разреженной паре
+    void to_dense(uint32_t entry, size_t& index, uint8_t& rank) const {
+        unsigned extra = sparse_precision - precision;
+        uint32_t sparse = sparse_index(entry);
+        uint32_t between = sparse & ((1u << extra) - 1);
+
+        index = sparse >> extra;
+        if (between != 0) rank = (uint8_t)(extra - (32 - __builtin_clz(between)) + 1);
+        else rank = (uint8_t)(extra + sparse_rank(entry));
+    }
+
+    // сливает буфер со списком, для одинаковых номеров остаётся больший ранг
+    void flush_buffer() {
+        if (sparse_buffer.empty()) return;
+
+        std::sort(sparse_buffer.begin(), sparse_buffer.end());
+        std::vector<uint32_t> merged;
+        merged.reserve(sparse_list.size() + sparse_buffer.size());
+        std::merge(sparse_list.begin(), sparse_list.end(), sparse_buffer.begin(), sparse_buffer.end(),
+                   std::back_inserter(merged));
+        sparse_buffer.clear();
+
+        // пары с одним номером идут подряд по возрастанию ранга
+        sparse_list.clear();
+        for (uint32_t entry : merged) {
+            if (!sparse_list.empty() && sparse_index(sparse_list.back()) == sparse_index(entry))
+                sparse_list.back() = entry;
+            else
+                sparse_list.push_back(entry);
+        }
+
+        // разреженное представление выгодно, пока оно меньше регистров
+        if (sparse_list.size() * sizeof(uint32_t) > register_count) convert_to_dense();
+    }
+
+    void convert_to_dense() {
+        registers.assign(register_count, 0);
+        for (uint32_t entry : sparse_list) {
+            size_t index;
+            uint8_t rank;
+            to_dense(entry, index, rank);
+            registers[index] = std::max(registers[index], rank);
+        }
+
+        sparse = false;
+        sparse_list = std::vector<uint32_t>();
+        sparse_buffer = std::vector<uint32_t>();
+    }
+
+    static double sigma(double x) {
+        if (x == 1.0) return std::numeric_limits<double>::infinity();
+
+        double y = 1.0;
+        double z = x;
+        while (true) {
+            x *= x;
+            double previous = z;
+            z += x * y;
+            y += y;
+            if (z == previous) return z;
+        }
+    }
+
+    static double tau(double x) {
+        if (x == 0.0 || x == 1.0) return 0.0;
+
+        double y = 1.0;
+        double z = 1.0 - x;
+        while (true) {
+            x = std::sqrt(x);
+            double previous = z;
+            y *= 0.5;
+            z -= (1.0 - x) * (1.0 - x) * y;
+            if (z == previous) return z / 3.0;
+        }
+    }
+
+    // оценка Эртла по гистограмме рангов: без смещения во всём диапазоне,
+    // таблицы эмпирических поправок HyperLogLog++ не нужны
+    double estimate_dense() const {
+        unsigned max_rank = 64 - precision;
+        std::vector<size_t> histogram(max_rank + 2, 0);
+        for (uint8_t rank : registers) histogram[rank]++;
+
+        double m = (double)register_count;
+        double z = m * tau(1.0 - histogram[max_rank + 1] / m);
+        for (unsigned k = max_rank; k >= 1; k--) {
+            z = 0.5 * (z + histogram[k]);
+        }
+        z += m * sigma(histogram[0] / m);
+
+        return m * m / (2.0 * std::log(2.0) * z);
+    }
+
+public:
+    explicit Distinct_Counter(unsigned precision = 14)
+        : precision(precision), register_count(size_t(1) << precision), sparse(true)
+    {
+        if (precision < 4 || precision > 18)
+            throw std::invalid_argument("Precision must be in [4, 18]");
+    }
+
+    void add(const T& value) {
+        uint64_t hash = hash_of(value);
+
+        if (sparse) {
+            uint32_t index = (uint32_t)(hash >> (64 - sparse_precision));
+            sparse_buffer.push_back((index << rank_bits) | rank_of(hash, sparse_precision));
+            if (sparse_buffer.size() * sizeof(uint32_t) >= register_count / 4) flush_buffer();
+            return;
+        }
+
+        size_t index = hash >> (64 - precision);
+        registers[index] = std::max(registers[index], rank_of(hash, precision));
+    }
+
+    void add_batch(const T* data, size_t n) {
+        for (size_t i = 0; i < n; i++) add(data[i]);
+    }
+
+    size_t consume(Read_Only_Stream<T>& stream, size_t limit = std::numeric_limits<size_t>::max()) {
+        return read_in_batches(stream, limit, [this](const T* data, size_t n) { add_batch(data, n); });
+    }
+
+    size_t consume(Shared_Ptr<Lazy_Sequence<T>> sequence, size_t count) {
+        Lazy_Read_Only_Stream<T> stream(sequence);
+        return consume(stream, count);
+    }
+
+    void merge(const Distinct_Counter& other) {
+        if (other.precision != precision)
+            throw std::invalid_argument("Only counters with the same precision can be merged");
+
+        if (sparse && other.sparse) {
+            sparse_buffer.insert(sparse_buffer.end(), other.sparse_list.begin(), other.sparse_list.end());
+            sparse_buffer.insert(sparse_buffer.end(), other.sparse_buffer.begin(), other.sparse_buffer.end());
+            flush_buffer();
+            return;
+        }
+
+        if (sparse) {
+            flush_buffer();
+            if (sparse) convert_to_dense();
+        }
+
+        if (other.sparse) {
+            Distinct_Counter copy = other;
+            copy.flush_buffer();
+            if (copy.sparse) copy.convert_to_dense();
+            for (size_t i = 0; i < register_count; i++) registers[i] = std::max(registers[i], copy.registers[i]);
+            return;
+        }
+
+        for (size_t i = 0; i < register_count; i++) registers[i] = std::max(registers[i], other.registers[i]);
+    }
+
+    double estimate() const {
+        if (!sparse) return estimate_dense();
+
+        // различные номера в списке и ещё не слитом буфере
+        std::vector<uint32_t> pending;
+        pending.reserve(sparse_buffer.size());
+        for (uint32_t entry : sparse_buffer) pending.push_back(sparse_index(entry));
+        std::sort(pending.begin(), pending.end());
+        pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+        size_t used = sparse_list.size();
+        size_t position = 0;
+        for (uint32_t index : pending) {
+            while (position < sparse_list.size() && sparse_index(sparse_list[position]) < index) position++;
+            if (position == sparse_list.size() || sparse_index(sparse_list[position]) != index) used++;
+        }
+
+        // линейный подсчёт по 2^25 виртуальным регистрам
+        double m = (double)(size_t(1) << sparse_precision);
+        return m * std::log(m / (m - used));
+    }
+
+    double get_error() const {
+        return 1.04 / std::sqrt((double)register_count);
+    }
+
+    bool is_sparse() const { return sparse; }
+
+    size_t get_memory_usage() const {
+        return sizeof(*this) + registers.size() + (sparse_list.size() + sparse_buffer.size()) * sizeof(uint32_t);
+    }
+
+    void clear() {
+        sparse = true;
+        sparse_list.clear();
+        sparse_buffer.clear();
+        registers = std::vector<uint8_t>();
+    }
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "LazySequence.hpp"
+#include "ReadOnlyStream.hpp"
+#include "SharedPtr.hpp"
+
+// Оценка частот в фиксированной памяти (Count-Min с консервативным обновлением).
+// depth строк по width счётчиков, в каждой строке своя хеш-функция; оценка -
+// минимум по строкам, никогда не меньше истинной частоты. Консервативное
+// обновление поднимает только счётчики, которые меньше новой оценки.
+template <typename T>
+class Frequency_Sketch {
+private:
+    size_t width;
+    size_t depth;
+    std::vector<uint64_t> counters; // строка за строкой
+    uint64_t total;
+
+private:
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    size_t slot(size_t row, uint64_t hash) const {
+        return row * width + mix(hash + row * 0x632BE59BD9B4E019ull) % width;
+    }
+
+public:
+    Frequency_Sketch(size_t width, size_t depth)
+        : width(width), depth(depth), counters(width * depth, 0), total(0)
+    {
+        if (width == 0 || depth == 0)
+            throw std::invalid_argument("Sketch width and depth must be positive");
+    }
+
+    // ошибка оценки не больше epsilon * total с вероятностью 1 - delta
+    static Frequency_Sketch with_error(double epsilon, double delta) {
+        if (epsilon <= 0.0 || delta <= 0.0 || delta >= 1.0)
+            throw std::invalid_argument("Error bounds must be positive and delta below 1");
+
+        return Frequency_Sketch((size_t)std::ceil(std::exp(1.0) / epsilon),
+                                (size_t)std::ceil(std::log(1.0 / delta)));
+    }
+
+    void add(const T& value, uint64_t count = 1) {
+        uint64_t hash = std::hash<T>()(value);
+
+        uint64_t estimate = std::numeric_limits<uint64_t>::max();
+        for (size_t row = 0; row < depth; row++) {
+            estimate = std::min(estimate, counters[slot(row, hash)]);
+        }
+
+        uint64_t updated = estimate + count;
+        for (size_t row = 0; row < depth; row++) {
+            uint64_t& counter = counters[slot(row, hash)];
+            counter = std::max(counter, updated);
+        }
+
+        total += count;
+    }
+
+    void add_batch(const T* data, size_t n) {
+        for (size_t i = 0; i < n; i++) add(data[i]);
+    }
+
+    size_t consume(Read_Only_Stream<T>& stream, size_t limit = std::numeric_limits<size_t>::max()) {
+        return read_in_batches(stream, limit, [this](const T* data, size_t n) { add_batch(data, n); });
+    }
+
+    // первые count элементов последовательности
+    size_t consume(Shared_Ptr<Lazy_Sequence<T>> sequence, size_t count) {
+        Lazy_Read_Only_Stream<T> stream(sequence);
+        return consume(stream, count);
+    }
+
+    uint64_t estimate(const T& value) const {
+        uint64_t hash = std::hash<T>()(value);
+
+        uint64_t result = std::numeric_limits<uint64_t>::max();
+        for (size_t row = 0; row < depth; row++) {
+            result = std::min(result, counters[slot(row, hash)]);
+        }
+        return result;
+    }
+
+    // сумма счётчиков - тоже верхняя оценка, хотя и менее точная, чем у единого эскиза
+    void merge(const Frequency_Sketch& other) {
+        if (other.width != width || other.depth != depth)
+            throw std::invalid_argument("Only sketches of the same shape can be merged");
+
+        for (size_t i = 0; i < counters.size(); i++) counters[i] += other.counters[i];
+        total += other.total;
+    }
+
+    uint64_t get_total() const { return total; }
+
+    size_t get_width() const { return width; }
+
+    size_t get_depth() const { return depth; }
+
+    size_t get_memory_usage() const {
+        return sizeof(*this) + counters.size() * sizeof(uint64_t);
+    }
+
+    void clear() {
+        std::fill(counters.begin(), counters.end(), 0);
+        total = 0;
+    }
+};
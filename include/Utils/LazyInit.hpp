@@ -6,4 +6,6 @@
 
 Shared_Ptr<Lazy_Sequence<int>> init_by_prod_func();
 Shared_Ptr<Lazy_Sequence<int>> init_by_sequence();
+Shared_Ptr<Lazy_Sequence<int>> init_by_binary_file();
+Shared_Ptr<Lazy_Sequence<int>> init_by_text_file();
 Shared_Ptr<Lazy_Sequence<int>> init_new_lazy_seq();
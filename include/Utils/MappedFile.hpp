@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// отображение файла в память только для чтения
+class Mapped_File {
+private:
+    int fd;
+    char* data;
+    size_t size;
+
+private:
+    void close() noexcept;
+
+public:
+    explicit Mapped_File(const std::string& path);
+    ~Mapped_File();
+
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator=(const Mapped_File&) = delete;
+
+    Mapped_File(Mapped_File&& other) noexcept;
+    Mapped_File& operator=(Mapped_File&& other) noexcept;
+
+    const char* get_data() const { return data; }
+    size_t get_size() const { return size; }
+};
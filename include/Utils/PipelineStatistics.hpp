@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include "LazySequence.hpp"
+#include "SharedPtr.hpp"
+#include "NumberStatistics.hpp"
+#include "QuantileSketch.hpp"
+#include "DistinctCounter.hpp"
+#include "RunningQuantile.hpp"
+
+// Чем считать квантили: точно на дереве (память O(n)) или эскизом (память O(k log n))
+enum Quantile_Mode {
+    quantile_exact,
+    quantile_sketch
+};
+
+// Статистика по первым элементам конвейера, которая переживает его правки.
+// При замене конвейера общий с прежним префикс берётся из get_shared_prefix,
+// состояние откатывается к нему, а дочитывается только изменившийся хвост.
+// Хранится только выбранный при создании счётчик квантилей.
+// Точные квантили откатываются удалением элементов, сводка и эскизы -
+// к ближайшему сохранённому снимку с дочитыванием не больше checkpoint_interval элементов.
+// Снимков не больше max_snapshots: при переполнении остаётся каждый второй,
+// а шаг удваивается, так что память на снимки не растёт с длиной потока.
+template <typename T>
+class Pipeline_Statistics {
+private:
+    struct Snapshot {
+        Number_Statistics<T> summary;
+        std::optional<Quantile_Sketch<T>> sketch;
+        Distinct_Counter<T> distinct;
+    };
+
+    static constexpr size_t max_snapshots = 32;
+
+    Shared_Ptr<Lazy_Sequence<T>> sequence;
+    size_t checkpoint_interval;
+
+    size_t consumed; // элементов учтено в статистике
+    size_t target;   // сколько элементов должно быть учтено
+
+    Quantile_Mode mode;
+    std::optional<Running_Quantile<T>> exact;
+    Number_Statistics<T> summary;
+    std::optional<Quantile_Sketch<T>> sketch;
+    Distinct_Counter<T> distinct;
+    std::vector<Snapshot> snapshots; // snapshots[i] - состояние после i * checkpoint_interval элементов
+
+    size_t read_count; // сколько элементов прочитано из конвейеров за всё время
+
+private:
+    void take_snapshot() {
+        if (snapshots.size() == max_snapshots) {
+            for (size_t i = 1; i < max_snapshots / 2; i++) {
+                snapshots[i] = std::move(snapshots[2 * i]);
+            }
+            snapshots.resize(max_snapshots / 2);
+            checkpoint_interval *= 2;
+        }
+        snapshots.push_back({summary, sketch, distinct});
+    }
+
+    // сводка и счётчик различных - пачкой, пачка режется по границам снимков
+    void consume_batch(const T* data, size_t n) {
+        while (n > 0) {
+            size_t part = std::min(n, checkpoint_interval - consumed % checkpoint_interval);
+
+            summary.consume_batch(data, part);
+            distinct.add_batch(data, part);
+            for (size_t i = 0; i < part; i++) {
+                if (exact) exact->insert(data[i]);
+                if (sketch) sketch->add(data[i]);
+            }
+
+            consumed += part;
+            data += part;
+            n -= part;
+
+            if (consumed % checkpoint_interval == 0)
+                take_snapshot();
+        }
+    }
+
+    // дочитывает до target элементов, сколько есть в конвейере
+    void sync() {
+        if (consumed >= target) return;
+
+        Lazy_Read_Only_Stream<T> stream(sequence);
+        stream.seek(consumed);
+        read_count += read_in_batches(stream, target - consumed,
+            [this](const T* data, size_t n) { consume_batch(data, n); });
+    }
+
+    // возвращает состояние к первым prefix элементам старого конвейера
+    void rollback(size_t prefix) {
+        if (exact) {
+            for (size_t i = prefix; i < consumed; i++) {
+                exact->erase(sequence->get(i));
+            }
+        }
+
+        size_t snapshot = prefix / checkpoint_interval;
+        snapshots.resize(snapshot + 1);
+        summary = snapshots[snapshot].summary;
+        sketch = snapshots[snapshot].sketch;
+        distinct = snapshots[snapshot].distinct;
+
+        size_t from = snapshot * checkpoint_interval;
+        Lazy_Read_Only_Stream<T> stream(sequence);
+        stream.seek(from);
+        read_in_batches(stream, prefix - from, [this](const T* data, size_t n) {
+            summary.consume_batch(data, n);
+            distinct.add_batch(data, n);
+            if (sketch) {
+                for (size_t i = 0; i < n; i++) sketch->add(data[i]);
+            }
+        });
+
+        consumed = prefix;
+    }
+
+public:
+    Pipeline_Statistics(Shared_Ptr<Lazy_Sequence<T>> sequence, size_t checkpoint_interval = 8192,
+                        Quantile_Mode mode = quantile_sketch)
+        : sequence(sequence), checkpoint_interval(checkpoint_interval),
+          consumed(0), target(0), mode(mode), read_count(0)
+    {
+        if (checkpoint_interval == 0)
+            throw std::invalid_argument("Checkpoint interval must be positive");
+
+        if (mode == quantile_exact) exact.emplace();
+        else sketch.emplace();
+
+        snapshots.push_back({summary, sketch, distinct});
+    }
+
+    // учитывать первые count элементов, статистика дочитывается при запросе
+    void advance_to(size_t count) {
+        target = std::max(target, count);
+    }
+
+    // конвейер заменён, например после append или map
+    void rebind(Shared_Ptr<Lazy_Sequence<T>> next) {
+        size_t prefix = std::min(consumed, next->get_shared_prefix(sequence.get()));
+        if (prefix < consumed) rollback(prefix);
+
+        sequence = next;
+    }
+
+    Quantile_Mode get_mode() const {
+        return mode;
+    }
+
+    // квантиль выбранным счётчиком
+    double get_quantile(double q) {
+        sync();
+        if (exact) return exact->quantile(q);
+        return static_cast<double>(sketch->quantile(q));
+    }
+
+    const Running_Quantile<T>& get_exact() {
+        if (!exact)
+            throw std::runtime_error("Exact quantiles are not tracked in sketch mode");
+        sync();
+        return *exact;
+    }
+
+    const Number_Statistics<T>& get_summary() {
+        sync();
+        return summary;
+    }
+
+    const Quantile_Sketch<T>& get_sketch() {
+        if (!sketch)
+            throw std::runtime_error("Quantile sketch is not tracked in exact mode");
+        sync();
+        return *sketch;
+    }
+
+    const Distinct_Counter<T>& get_distinct() {
+        sync();
+        return distinct;
+    }
+
+    size_t get_snapshot_count() const {
+        return snapshots.size();
+    }
+
+    size_t get_snapshot_memory() const {
+        size_t memory = snapshots.capacity() * sizeof(Snapshot);
+        for (const Snapshot& snapshot : snapshots) {
+            if (snapshot.sketch) memory += snapshot.sketch->get_memory_usage();
+            memory += snapshot.distinct.get_memory_usage();
+        }
+        return memory;
+    }
+
+    size_t get_consumed_count() const {
+        return consumed;
+    }
+
+    size_t get_read_count() const {
+        return read_count;
+    }
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Последовательное чтение файла блоками через pread в отдельном потоке.
+// Буферы выровнены и используются по кругу: пока читатель разбирает один блок,
+// следующие уже читаются с диска.
+class Prefetching_Reader {
+public:
+    static constexpr size_t alignment = 4096;
+
+private:
+    struct Buffer {
+        char* data;
+        size_t size;
+    };
+
+    int fd;
+    bool direct;
+    size_t file_size;
+    size_t block_size;
+
+    std::vector<Buffer> buffers;
+    size_t head;        // буфер, который разбирает читатель
+    size_t filled;      // готовых буферов начиная с head
+    size_t next_offset; // откуда читать следующий блок
+    bool stopping;
+    bool failed;
+
+    std::mutex mutex;
+    std::condition_variable can_read;
+    std::condition_variable can_fill;
+    std::thread worker;
+
+private:
+    void run();
+    void start(size_t offset);
+    void stop() noexcept;
+    void close() noexcept;
+
+public:
+    // block_size округляется вверх до alignment; direct - читать мимо кэша страниц, если ФС позволяет
+    Prefetching_Reader(const std::string& path, size_t block_size, size_t buffer_count = 2, bool direct = false);
+    ~Prefetching_Reader();
+
+    Prefetching_Reader(const Prefetching_Reader&) = delete;
+    Prefetching_Reader& operator=(const Prefetching_Reader&) = delete;
+
+    // следующий блок, nullptr в конце файла; действителен до release
+    const char* acquire(size_t& size);
+    void release();
+
+    // начать чтение заново с offset, кратного размеру блока
+    void restart(size_t offset);
+
+    size_t get_file_size() const { return file_size; }
+    size_t get_block_size() const { return block_size; }
+    bool is_direct() const { return direct; }
+};
@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Приближённые квантили потока в фиксированной памяти (KLL).
+// Элементы лежат в уровнях-компакторах, элемент уровня h заменяет 2^h исходных.
+// Переполненный уровень сортируется, и каждый второй его элемент уходит уровнем выше.
+// Ёмкость убывает вниз по уровням как (2/3)^глубина, поэтому хранится O(k) элементов,
+// а ошибка ранга около 1.7 / k от длины потока. Эскизы с одинаковым k можно сливать.
+template <typename T>
+class Quantile_Sketch {
+private:
+    static constexpr size_t min_capacity = 2;
+
+    size_t k;
+    size_t count;
+    size_t retained;
+    size_t retained_limit; // суммарная ёмкость уровней, меняется только с их числом
+    std::vector<std::vector<T>> levels;
+
+    T min_val;
+    T max_val;
+
+    uint64_t random_state; // выбор чётных или нечётных при сжатии
+
+private:
+    size_t capacity(size_t level) const {
+        size_t depth = levels.size() - level - 1;
+        return std::max(min_capacity, (size_t)std::ceil(k * std::pow(2.0 / 3.0, (double)depth)));
+    }
+
+    void update_limit() {
+        retained_limit = 0;
+        for (size_t level = 0; level < levels.size(); level++) retained_limit += capacity(level);
+    }
+
+    bool random_bit() {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 7;
+        random_state ^= random_state << 17;
+        return random_state & 1;
+    }
+
+    // сжимает самый нижний переполненный уровень
+    void compress() {
+        for (size_t level = 0; level < levels.size(); level++) {
+            if (levels[level].size() < capacity(level)) continue;
+
+            if (level + 1 == levels.size()) {
+                levels.emplace_back();
+                update_limit();
+            }
+
+            std::vector<T>& items = levels[level];
+            std::sort(items.begin(), items.end());
+
+            // при нечётном размере один элемент остаётся на месте
+            T leftover = items.back();
+            bool has_leftover = items.size() % 2 == 1;
+            if (has_leftover) items.pop_back();
+
+            std::vector<T>& next = levels[level + 1];
+            for (size_t i = random_bit() ? 1 : 0; i < items.size(); i += 2) {
+                next.push_back(items[i]);
+            }
+
+            retained -= items.size() / 2;
+            items.clear();
+            if (has_leftover) items.push_back(leftover);
+            return;
+        }
+    }
+
+    void compress_to_fit() {
+        while (retained > retained_limit) compress();
+    }
+
+    // элементы с весами, отсортированные по значению
+    std::vector<std::pair<T, size_t>> weighted_items() const {
+        std::vector<std::pair<T, size_t>> items;
+        items.reserve(retained);
+
+        for (size_t level = 0; level < levels.size(); level++) {
+            for (const T& item : levels[level]) items.emplace_back(item, size_t(1) << level);
+        }
+
+        std::sort(items.begin(), items.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        return items;
+    }
+
+public:
+    explicit Quantile_Sketch(size_t k = 200)
+        : k(k), count(0), retained(0), retained_limit(0), levels(1), min_val(), max_val(),
+          random_state(0x9E3779B97F4A7C15ull)
+    {
+        if (k < 8)
+            throw std::invalid_argument("Sketch parameter k must be at least 8");
+
+        update_limit();
+    }
+
+    // наименьший k, при котором ошибка ранга не больше epsilon
+    static Quantile_Sketch with_error(double epsilon) {
+        if (epsilon <= 0.0 || epsilon >= 1.0)
+            throw std::invalid_argument("Error bound must be in (0, 1)");
+
+        return Quantile_Sketch(std::max<size_t>(8, (size_t)std::ceil(1.7 / epsilon)));
+    }
+
+    void add(const T& value) {
+        if (count == 0) {
+            min_val = max_val = value;
+        } else {
+            if (value < min_val) min_val = value;
+            if (max_val < value) max_val = value;
+        }
+
+        levels[0].push_back(value);
+        count++;
+        retained++;
+        compress_to_fit();
+    }
+
+    void merge(const Quantile_Sketch& other) {
+        if (other.k != k)
+            throw std::invalid_argument("Only sketches with the same k can be merged");
+        if (other.count == 0) return;
+
+        if (count == 0) {
+            min_val = other.min_val;
+            max_val = other.max_val;
+        } else {
+            if (other.min_val < min_val) min_val = other.min_val;
+            if (max_val < other.max_val) max_val = other.max_val;
+        }
+
+        if (levels.size() < other.levels.size()) {
+            levels.resize(other.levels.size());
+            update_limit();
+        }
+        for (size_t level = 0; level < other.levels.size(); level++) {
+            levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+        }
+
+        count += other.count;
+        retained += other.retained;
+        compress_to_fit();
+    }
+
+    // q из [0, 1]; края потока известны точно
+    T quantile(double q) const {
+        if (count == 0)
+            throw std::runtime_error("Cannot calculate quantile: no elements");
+        if (q < 0.0 || q > 1.0)
+            throw std::invalid_argument("Quantile must be in [0, 1]");
+
+        if (q == 0.0) return min_val;
+        if (q == 1.0) return max_val;
+
+        auto items = weighted_items();
+        double target = q * count;
+        size_t weight = 0;
+        for (const auto& [item, item_weight] : items) {
+            weight += item_weight;
+            if (weight > target) return item;
+        }
+        return max_val;
+    }
+
+    // приблизительное число элементов строго меньше value
+    size_t rank(const T& value) const {
+        size_t result = 0;
+        for (size_t level = 0; level < levels.size(); level++) {
+            for (const T& item : levels[level]) {
+                if (item < value) result += size_t(1) << level;
+            }
+        }
+        return result;
+    }
+
+    double get_median() const {
+        return static_cast<double>(quantile(0.5));
+    }
+
+    // ожидаемая ошибка ранга как доля длины потока
+    double get_error() const {
+        return 1.7 / k;
+    }
+
+    size_t get_count() const { return count; }
+
+    size_t get_retained() const { return retained; }
+
+    size_t get_memory_usage() const {
+        return sizeof(*this) + levels.size() * sizeof(std::vector<T>) + retained * sizeof(T);
+    }
+
+    void clear() {
+        count = 0;
+        retained = 0;
+        levels.assign(1, std::vector<T>());
+        update_limit();
+    }
+};
@@ -1,59 +1,54 @@
 #pragma once
-#include "BinaryTree.hpp"
+#include <functional>
+#include <queue>
 #include <stdexcept>
-#include <optional>
+#include <vector>
 
+// Медиана потока на двух кучах: в lower - меньшая половина (вершина - максимум),
+// в upper - большая (вершина - минимум). lower длиннее не больше чем на один элемент,
+// поэтому медиана всегда на вершинах. Добавление O(log n), запрос O(1).
+// Повторяющиеся значения учитываются каждое отдельно.
 template<typename T>
 class Running_Median {
 private:
-    BinaryTree<T> tree;
-    mutable std::optional<double> cached_median;
-    mutable bool is_cache_valid = false;
-  
-private:
-    void invalidate_cache() {
-        is_cache_valid = false;
-        cached_median.reset();
-    }
-    
-    double compute_median() const {
-        if (!is_cache_valid) {
-            auto it = tree.iterator();
-            size_t size = it.get_size();
-            
-            if (size == 0) {
-                throw std::runtime_error("Cannot calculate median: no elements");
-            }
-            
-            if (size % 2 == 1) {
-                cached_median = static_cast<double>(it.get_at(size / 2));
-            } else {
-                T mid1 = it.get_at(size / 2 - 1);
-                T mid2 = it.get_at(size / 2);
-                cached_median = (static_cast<double>(mid1) + static_cast<double>(mid2)) / 2.0;
-            }
-            
-            is_cache_valid = true;
-        }
-        
-        return cached_median.value();
-    }
-    
+    std::priority_queue<T> lower;
+    std::priority_queue<T, std::vector<T>, std::greater<T>> upper;
+
 public:
     Running_Median() = default;
     
     void add(const T& value) {
-        tree.add(value);
-        invalidate_cache();
+        if (lower.empty() || !(lower.top() < value)) lower.push(value);
+        else upper.push(value);
+
+        if (lower.size() > upper.size() + 1) {
+            upper.push(lower.top());
+            lower.pop();
+        } else if (upper.size() > lower.size()) {
+            lower.push(upper.top());
+            upper.pop();
+        }
     }
     
     double get_median() const {
-        return compute_median();
+        if (lower.empty()) {
+            throw std::runtime_error("Cannot calculate median: no elements");
+        }
+
+        if (lower.size() > upper.size()) {
+            return static_cast<double>(lower.top());
+        }
+
+        return (static_cast<double>(lower.top()) + static_cast<double>(upper.top())) / 2.0;
+    }
+
+    size_t get_size() const {
+        return lower.size() + upper.size();
     }
     
     void clear() {
-        tree = BinaryTree<T>();
-        invalidate_cache();
+        lower = std::priority_queue<T>();
+        upper = std::priority_queue<T, std::vector<T>, std::greater<T>>();
     }
     
-};
\ No newline at end of file
+};
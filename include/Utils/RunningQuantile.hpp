@@ -0,0 +1,60 @@
+#pragma once
+#include <cmath>
+#include <stdexcept>
+#include "OrderStatisticTree.hpp"
+
+// Произвольные квантили потока на дереве порядковых статистик.
+// В отличие от Running_Median элементы можно и удалять, например при сдвиге окна.
+template <typename T>
+class Running_Quantile {
+private:
+    OrderStatisticTree<T> tree;
+
+public:
+    Running_Quantile() = default;
+
+    void insert(const T& value) {
+        tree.insert(value);
+    }
+
+    void erase(const T& value) {
+        tree.erase(value);
+    }
+
+    const T& select(size_t k) const {
+        return tree.select(k);
+    }
+
+    size_t rank(const T& value) const {
+        return tree.rank(value);
+    }
+
+    // q из [0, 1], между соседними порядковыми статистиками - линейная интерполяция
+    double quantile(double q) const {
+        if (tree.get_size() == 0)
+            throw std::runtime_error("Cannot calculate quantile: no elements");
+        if (q < 0.0 || q > 1.0)
+            throw std::invalid_argument("Quantile must be in [0, 1]");
+
+        double position = q * (tree.get_size() - 1);
+        size_t lower = (size_t)std::floor(position);
+        double fraction = position - lower;
+
+        double value = static_cast<double>(tree.select(lower));
+        if (fraction == 0.0) return value;
+
+        return value + fraction * (static_cast<double>(tree.select(lower + 1)) - value);
+    }
+
+    double get_median() const {
+        return quantile(0.5);
+    }
+
+    size_t get_size() const {
+        return tree.get_size();
+    }
+
+    void clear() {
+        tree.clear();
+    }
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// сводка по непрерывному блоку: сумма точная, m2 - сумма квадратов отклонений от среднего блока
+struct Int_Block_Summary {
+    int64_t sum;
+    int min;
+    int max;
+    double m2;
+};
+
+// n > 0; набор инструкций (AVX-512F, AVX2 или скалярный код) выбирается при первом вызове
+Int_Block_Summary summarize_int_block(const int* data, size_t n);
+
+// название выбранной реализации, для отладки и тестов
+const char* get_int_kernel_name();
@@ -0,0 +1,161 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "LazySequence.hpp"
+#include "ReadOnlyStream.hpp"
+#include "SharedPtr.hpp"
+
+template <typename T>
+struct Frequent_Item {
+    T value;
+    uint64_t count; // верхняя оценка частоты
+    uint64_t error; // count - error - нижняя оценка
+};
+
+// Самые частые значения потока в памяти на capacity элементов (Space-Saving).
+// Новое значение при заполненной таблице вытесняет самое редкое и наследует
+// его счётчик как ошибку. Любое значение с частотой выше total / capacity
+// гарантированно остаётся в таблице.
+template <typename T>
+class Top_K_Frequent {
+private:
+    size_t capacity;
+    uint64_t total;
+
+    std::vector<Frequent_Item<T>> items;
+    std::unordered_map<T, size_t> positions;       // значение -> индекс в items
+    std::set<std::pair<uint64_t, size_t>> by_count; // (count, индекс), самое редкое первое
+
+private:
+    void increase(size_t index, uint64_t count) {
+        by_count.erase({items[index].count, index});
+        items[index].count += count;
+        by_count.insert({items[index].count, index});
+    }
+
+    // счётчик, который получило бы отсутствующее значение
+    uint64_t floor_count() const {
+        return items.size() < capacity ? 0 : by_count.begin()->first;
+    }
+
+public:
+    explicit Top_K_Frequent(size_t capacity) : capacity(capacity), total(0) {
+        if (capacity == 0)
+            throw std::invalid_argument("Capacity must be positive");
+
+        items.reserve(capacity);
+        positions.reserve(capacity);
+    }
+
+    void add(const T& value, uint64_t count = 1) {
+        total += count;
+
+        auto found = positions.find(value);
+        if (found != positions.end()) {
+            increase(found->second, count);
+            return;
+        }
+
+        if (items.size() < capacity) {
+            positions[value] = items.size();
+            items.push_back({value, 0, 0});
+            by_count.insert({0, items.size() - 1});
+            increase(items.size() - 1, count);
+            return;
+        }
+
+        size_t index = by_count.begin()->second;
+        uint64_t evicted = items[index].count;
+
+        positions.erase(items[index].value);
+        positions[value] = index;
+        items[index].value = value;
+        items[index].error = evicted;
+        increase(index, count);
+    }
+
+    void add_batch(const T* data, size_t n) {
+        for (size_t i = 0; i < n; i++) add(data[i]);
+    }
+
+    size_t consume(Read_Only_Stream<T>& stream, size_t limit = std::numeric_limits<size_t>::max()) {
+        return read_in_batches(stream, limit, [this](const T* data, size_t n) { add_batch(data, n); });
+    }
+
+    size_t consume(Shared_Ptr<Lazy_Sequence<T>> sequence, size_t count) {
+        Lazy_Read_Only_Stream<T> stream(sequence);
+        return consume(stream, count);
+    }
+
+    // объединение сводок: отсутствующему в сводке значению приписывается её минимальный счётчик
+    void merge(const Top_K_Frequent& other) {
+        std::unordered_map<T, Frequent_Item<T>> combined;
+        uint64_t own_floor = floor_count();
+        uint64_t other_floor = other.floor_count();
+
+        for (const auto& item : items) {
+            combined[item.value] = {item.value, item.count + other_floor, item.error + other_floor};
+        }
+        for (const auto& item : other.items) {
+            auto found = combined.find(item.value);
+            if (found != combined.end()) {
+                found->second.count += item.count - other_floor;
+                found->second.error += item.error - other_floor;
+            } else {
+                combined[item.value] = {item.value, item.count + own_floor, item.error + own_floor};
+            }
+        }
+
+        std::vector<Frequent_Item<T>> merged;
+        merged.reserve(combined.size());
+        for (auto& entry : combined) merged.push_back(entry.second);
+
+        size_t keep = std::min(capacity, merged.size());
+        std::partial_sort(merged.begin(), merged.begin() + keep, merged.end(),
+                          [](const auto& a, const auto& b) { return a.count > b.count; });
+        merged.resize(keep);
+
+        uint64_t merged_total = total + other.total;
+        items.clear();
+        positions.clear();
+        by_count.clear();
+        for (const auto& item : merged) {
+            positions[item.value] = items.size();
+            by_count.insert({item.count, items.size()});
+            items.push_back(item);
+        }
+        total = merged_total;
+    }
+
+    // до n самых частых значений по убыванию счётчика
+    std::vector<Frequent_Item<T>> top(size_t n) const {
+        std::vector<Frequent_Item<T>> result;
+        for (auto it = by_count.rbegin(); it != by_count.rend() && result.size() < n; ++it) {
+            result.push_back(items[it->second]);
+        }
+        return result;
+    }
+
+    // верхняя оценка частоты, для вытесненных - минимальный счётчик
+    uint64_t estimate(const T& value) const {
+        auto found = positions.find(value);
+        return found == positions.end() ? floor_count() : items[found->second].count;
+    }
+
+    uint64_t get_total() const { return total; }
+
+    size_t get_capacity() const { return capacity; }
+
+    void clear() {
+        items.clear();
+        positions.clear();
+        by_count.clear();
+        total = 0;
+    }
+};
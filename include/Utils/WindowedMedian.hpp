@@ -0,0 +1,124 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+// Медиана последних window элементов на двух кучах с отложенным удалением:
+// вышедший из окна элемент только помечается в delayed и выбрасывается,
+// когда оказывается на вершине кучи. Обновление O(log W) амортизированно.
+template <typename T>
+class Windowed_Median {
+private:
+    size_t window;
+    std::deque<T> values; // окно в порядке поступления
+
+    std::priority_queue<T> lower;
+    std::priority_queue<T, std::vector<T>, std::greater<T>> upper;
+    std::map<T, size_t> delayed;
+
+    // живые элементы в кучах, без помеченных на удаление
+    size_t lower_size;
+    size_t upper_size;
+
+private:
+    template <typename Heap>
+    void prune(Heap& heap) {
+        while (!heap.empty()) {
+            auto it = delayed.find(heap.top());
+            if (it == delayed.end()) return;
+
+            if (--it->second == 0) delayed.erase(it);
+            heap.pop();
+        }
+    }
+
+    void rebalance() {
+        if (lower_size > upper_size + 1) {
+            upper.push(lower.top());
+            lower.pop();
+            lower_size--;
+            upper_size++;
+            prune(lower);
+        } else if (upper_size > lower_size) {
+            lower.push(upper.top());
+            upper.pop();
+            upper_size--;
+            lower_size++;
+            prune(upper);
+        }
+    }
+
+    void insert(const T& value) {
+        if (lower.empty() || !(lower.top() < value)) {
+            lower.push(value);
+            lower_size++;
+        } else {
+            upper.push(value);
+            upper_size++;
+        }
+        rebalance();
+    }
+
+    void remove(const T& value) {
+        delayed[value]++;
+
+        if (!(lower.top() < value)) {
+            lower_size--;
+            if (value == lower.top()) prune(lower);
+        } else {
+            upper_size--;
+            if (value == upper.top()) prune(upper);
+        }
+        rebalance();
+    }
+
+public:
+    explicit Windowed_Median(size_t window)
+        : window(window), lower_size(0), upper_size(0)
+    {
+        if (window == 0)
+            throw std::invalid_argument("Window must be positive");
+    }
+
+    void add(const T& value) {
+        values.push_back(value);
+        insert(value);
+
+        if (values.size() > window) {
+            T oldest = values.front();
+            values.pop_front();
+            remove(oldest);
+        }
+    }
+
+    double get_median() const {
+        if (values.empty()) {
+            throw std::runtime_error("Cannot calculate median: no elements");
+        }
+
+        if (lower_size > upper_size) {
+            return static_cast<double>(lower.top());
+        }
+
+        return (static_cast<double>(lower.top()) + static_cast<double>(upper.top())) / 2.0;
+    }
+
+    size_t get_size() const {
+        return values.size();
+    }
+
+    size_t get_window() const {
+        return window;
+    }
+
+    void clear() {
+        values.clear();
+        lower = std::priority_queue<T>();
+        upper = std::priority_queue<T, std::vector<T>, std::greater<T>>();
+        delayed.clear();
+        lower_size = upper_size = 0;
+    }
+};
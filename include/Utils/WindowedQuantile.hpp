@@ -0,0 +1,55 @@
+#pragma once
+#include <deque>
+#include <stdexcept>
+#include "RunningQuantile.hpp"
+
+// Квантили последних window элементов: дерево порядковых статистик
+// плюс очередь окна, из которой вышедший элемент удаляется за O(log W)
+template <typename T>
+class Windowed_Quantile {
+private:
+    size_t window;
+    std::deque<T> values;
+    Running_Quantile<T> quantiles;
+
+public:
+    explicit Windowed_Quantile(size_t window) : window(window) {
+        if (window == 0)
+            throw std::invalid_argument("Window must be positive");
+    }
+
+    void add(const T& value) {
+        values.push_back(value);
+        quantiles.insert(value);
+
+        if (values.size() > window) {
+            quantiles.erase(values.front());
+            values.pop_front();
+        }
+    }
+
+    double quantile(double q) const {
+        return quantiles.quantile(q);
+    }
+
+    double get_median() const {
+        return quantiles.get_median();
+    }
+
+    const T& select(size_t k) const {
+        return quantiles.select(k);
+    }
+
+    size_t get_size() const {
+        return values.size();
+    }
+
+    size_t get_window() const {
+        return window;
+    }
+
+    void clear() {
+        values.clear();
+        quantiles.clear();
+    }
+};
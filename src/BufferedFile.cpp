@@ -0,0 +1,68 @@
+#include "BufferedFile.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+Buffered_File::Buffered_File(const std::string& path)
+    : fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), owns_fd(true),
+      buffer(new char[buffer_size]), used(0)
+{
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file for writing: " + path);
+}
+
+Buffered_File::Buffered_File(int descriptor)
+    : fd(descriptor), owns_fd(false), buffer(new char[buffer_size]), used(0) {}
+
+Buffered_File::~Buffered_File() {
+    try {
+        flush();
+    } catch (const std::runtime_error&) {}
+
+    if (owns_fd) ::close(fd);
+}
+
+void Buffered_File::write_all(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Cannot write to file");
+        }
+
+        data += written;
+        size -= written;
+    }
+}
+
+void Buffered_File::append(const char* data, size_t size) {
+    if (used + size > buffer_size) {
+        flush();
+
+        if (size > buffer_size) {
+            write_all(data, size);
+            return;
+        }
+    }
+
+    std::memcpy(buffer.get() + used, data, size);
+    used += size;
+}
+
+char* Buffered_File::reserve(size_t size) {
+    if (size > buffer_size)
+        throw std::invalid_argument("Reserved size exceeds buffer");
+
+    if (used + size > buffer_size) flush();
+    return buffer.get() + used;
+}
+
+void Buffered_File::flush() {
+    if (used == 0) return;
+
+    size_t size = used;
+    used = 0;
+    write_all(buffer.get(), size);
+}
@@ -1,8 +1,13 @@
 #include "LazyInit.hpp"
 #include "IntegerInput.hpp"
+#include "MappedFileStream.hpp"
+#include "TextNumberStream.hpp"
 #include <iostream>
 #include <limits>
 
+// файлы читаются дёшево, их выгодно забирать блоками
+static const size_t file_block_size = 4096;
+
 Shared_Ptr<Lazy_Sequence<int>> init_by_prod_func() {
     std::cout << std::endl;
 
@@ -75,6 +80,26 @@ Shared_Ptr<Lazy_Sequence<int>> init_by_sequence() {
 }
 
 
+Shared_Ptr<Lazy_Sequence<int>> init_by_binary_file() {
+    std::cout << "Enter path:\n";
+    std::string path;
+    std::getline(std::cin, path);
+
+    auto stream = my::make_shared<Mapped_File_Stream<int>>(path);
+    return Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream, file_block_size));
+}
+
+
+Shared_Ptr<Lazy_Sequence<int>> init_by_text_file() {
+    std::cout << "Enter path:\n";
+    std::string path;
+    std::getline(std::cin, path);
+
+    auto stream = my::make_shared<Text_Number_Stream<int>>(path);
+    return Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream, file_block_size));
+}
+
+
 Shared_Ptr<Lazy_Sequence<int>> init_new_lazy_seq() {
     std::cout << std::endl;
 
@@ -83,20 +108,34 @@ Shared_Ptr<Lazy_Sequence<int>> init_new_lazy_seq() {
         std::cout << "Init Lazy Sequence\n"
                   << "1. By producing func\n"
                   << "2. By sequence\n"
+                  << "3. By binary file\n"
+                  << "4. By text file\n"
         ;
 
         int option = get_integer_input("Your choice: ");
 
-        switch (option) {
-            case 1:
-                return init_by_prod_func();
+        try {
+
+            switch (option) {
+                case 1:
+                    return init_by_prod_func();
+
+                case 2:
+                    return init_by_sequence();
+
+                case 3:
+                    return init_by_binary_file();
 
-            case 2:
-                return init_by_sequence();
+                case 4:
+                    return init_by_text_file();
+
+                default:
+                    std::cout << "No such option\n";
+                    break;
+            }
 
-            default:
-                std::cout << "No such option\n";
-                break;
+        } catch(const std::runtime_error& e) {
+            std::cout << e.what() << std::endl;
         }
 
         std::cout << std::endl;
@@ -0,0 +1,65 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Mapped_File::Mapped_File(const std::string& path) : fd(-1), data(nullptr), size(0) {
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        close();
+        throw std::runtime_error("Cannot stat file: " + path);
+    }
+
+    size = info.st_size;
+    if (size == 0) return;
+
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        throw std::runtime_error("Cannot map file: " + path);
+    }
+
+    data = static_cast<char*>(mapped);
+    ::madvise(data, size, MADV_SEQUENTIAL);
+}
+
+Mapped_File::~Mapped_File() {
+    close();
+}
+
+void Mapped_File::close() noexcept {
+    if (data) ::munmap(data, size);
+    if (fd >= 0) ::close(fd);
+
+    data = nullptr;
+    size = 0;
+    fd = -1;
+}
+
+Mapped_File::Mapped_File(Mapped_File&& other) noexcept
+    : fd(other.fd), data(other.data), size(other.size)
+{
+    other.fd = -1;
+    other.data = nullptr;
+    other.size = 0;
+}
+
+Mapped_File& Mapped_File::operator=(Mapped_File&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        data = other.data;
+        size = other.size;
+
+        other.fd = -1;
+        other.data = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
@@ -0,0 +1,33 @@
+#include "PipelineProfiler.hpp"
+#include <set>
+
+static void dump_node(const Pipeline_Node& node, std::ostream& out, size_t depth,
+    std::set<const Pipeline_Node*>& visited)
+{
+    for (size_t i = 0; i < depth; i++) out << "  ";
+    out << "- " << node.get_name();
+
+    if (visited.count(&node)) {
+        out << " (shared, see above)\n";
+        return;
+    }
+    visited.insert(&node);
+
+    Pipeline_Counters counters = node.get_counters();
+    out << ": produced=" << counters.produced
+        << " has_next=" << counters.has_next_probes
+        << " get=" << counters.get_calls
+        << " bytes=" << counters.bytes_materialized
+        << " time=" << std::chrono::duration<double, std::micro>(counters.time_spent).count() << "us\n";
+
+    std::vector<const Pipeline_Node*> upstream;
+    node.get_upstream(upstream);
+    for (const Pipeline_Node* child : upstream) {
+        dump_node(*child, out, depth + 1, visited);
+    }
+}
+
+void dump_pipeline(const Pipeline_Node& root, std::ostream& out) {
+    std::set<const Pipeline_Node*> visited;
+    dump_node(root, out, 0, visited);
+}
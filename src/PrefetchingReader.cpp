@@ -0,0 +1,155 @@
+#include "PrefetchingReader.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Prefetching_Reader::Prefetching_Reader(const std::string& path, size_t block_size, size_t buffer_count, bool direct)
+    : fd(-1), direct(false), file_size(0), block_size(0),
+      head(0), filled(0), next_offset(0), stopping(false), failed(false)
+{
+    if (block_size == 0 || buffer_count < 2)
+        throw std::invalid_argument("Prefetching needs a positive block size and at least two buffers");
+
+    this->block_size = (block_size + alignment - 1) / alignment * alignment;
+
+#ifdef O_DIRECT
+    if (direct) {
+        fd = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+        this->direct = fd >= 0;
+    }
+#endif
+    // O_DIRECT поддерживается не всеми файловыми системами
+    if (fd < 0) fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        close();
+        throw std::runtime_error("Cannot stat file: " + path);
+    }
+    file_size = info.st_size;
+
+    if (!this->direct) ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    for (size_t i = 0; i < buffer_count; i++) {
+        char* data = static_cast<char*>(std::aligned_alloc(alignment, this->block_size));
+        if (!data) {
+            close();
+            throw std::runtime_error("Cannot allocate read buffer");
+        }
+        buffers.push_back({data, 0});
+    }
+
+    start(0);
+}
+
+Prefetching_Reader::~Prefetching_Reader() {
+    stop();
+    close();
+}
+
+void Prefetching_Reader::close() noexcept {
+    for (Buffer& buffer : buffers) std::free(buffer.data);
+    buffers.clear();
+
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+}
+
+void Prefetching_Reader::start(size_t offset) {
+    head = 0;
+    filled = 0;
+    next_offset = offset;
+    stopping = false;
+    failed = false;
+
+    worker = std::thread(&Prefetching_Reader::run, this);
+}
+
+void Prefetching_Reader::stop() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    can_fill.notify_all();
+
+    if (worker.joinable()) worker.join();
+}
+
+void Prefetching_Reader::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        can_fill.wait(lock, [this]() { return stopping || filled < buffers.size(); });
+        if (stopping || next_offset >= file_size) return;
+
+        Buffer& buffer = buffers[(head + filled) % buffers.size()];
+        size_t offset = next_offset;
+        lock.unlock();
+
+        // с O_DIRECT размер запроса кратен блоку, в конце файла придёт меньше
+        size_t size = 0;
+        bool error = false;
+        while (size < block_size) {
+            ssize_t count = ::pread(fd, buffer.data + size, block_size - size, offset + size);
+            if (count < 0 && errno == EINTR) continue;
+            if (count < 0) {
+                error = true;
+                break;
+            }
+            if (count == 0) break;
+            size += count;
+        }
+
+        lock.lock();
+        if (error) {
+            failed = true;
+            can_read.notify_all();
+            return;
+        }
+
+        buffer.size = size;
+        filled++;
+        next_offset += block_size;
+        can_read.notify_all();
+    }
+}
+
+const char* Prefetching_Reader::acquire(size_t& size) {
+    std::unique_lock<std::mutex> lock(mutex);
+    can_read.wait(lock, [this]() { return filled > 0 || failed || next_offset >= file_size; });
+
+    if (filled == 0) {
+        if (failed)
+            throw std::runtime_error("Cannot read file block");
+
+        size = 0;
+        return nullptr;
+    }
+
+    size = buffers[head].size;
+    return buffers[head].data;
+}
+
+void Prefetching_Reader::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (filled == 0) return;
+
+        head = (head + 1) % buffers.size();
+        filled--;
+    }
+    can_fill.notify_one();
+}
+
+void Prefetching_Reader::restart(size_t offset) {
+    if (offset % block_size != 0)
+        throw std::invalid_argument("Restart offset must be a multiple of block size");
+
+    stop();
+    start(offset);
+}
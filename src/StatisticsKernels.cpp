@@ -0,0 +1,158 @@
+#include "StatisticsKernels.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STATISTICS_KERNELS_X86
+#endif
+
+// Два прохода по блоку, который целиком лежит в кэше:
+// сначала сумма, минимум и максимум, потом отклонения от среднего блока.
+
+static void finish_m2_scalar(const int* data, size_t from, size_t n, double mean, double& m2) {
+    for (size_t i = from; i < n; i++) {
+        double delta = data[i] - mean;
+        m2 += delta * delta;
+    }
+}
+
+static Int_Block_Summary summarize_scalar(const int* data, size_t n) {
+    Int_Block_Summary result{0, data[0], data[0], 0.0};
+    for (size_t i = 0; i < n; i++) {
+        result.sum += data[i];
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+
+    finish_m2_scalar(data, 0, n, (double)result.sum / n, result.m2);
+    return result;
+}
+
+#ifdef STATISTICS_KERNELS_X86
+
+__attribute__((target("avx2")))
+static Int_Block_Summary summarize_avx2(const int* data, size_t n) {
+    __m256i sum_low = _mm256_setzero_si256();
+    __m256i sum_high = _mm256_setzero_si256();
+    __m256i min_vec = _mm256_set1_epi32(data[0]);
+    __m256i max_vec = min_vec;
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        sum_low = _mm256_add_epi64(sum_low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        sum_high = _mm256_add_epi64(sum_high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        min_vec = _mm256_min_epi32(min_vec, x);
+        max_vec = _mm256_max_epi32(max_vec, x);
+    }
+
+    alignas(32) int64_t sums[4];
+    alignas(32) int mins[8];
+    alignas(32) int maxs[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_add_epi64(sum_low, sum_high));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(mins), min_vec);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), max_vec);
+
+    Int_Block_Summary result{sums[0] + sums[1] + sums[2] + sums[3], mins[0], maxs[0], 0.0};
+    for (int lane = 1; lane < 8; lane++) {
+        result.min = std::min(result.min, mins[lane]);
+        result.max = std::max(result.max, maxs[lane]);
+    }
+    for (; i < n; i++) {
+        result.sum += data[i];
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+
+    double mean = (double)result.sum / n;
+    __m256d mean_vec = _mm256_set1_pd(mean);
+    __m256d m2_vec = _mm256_setzero_pd();
+
+    i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m256d delta = _mm256_sub_pd(_mm256_cvtepi32_pd(x), mean_vec);
+        m2_vec = _mm256_add_pd(m2_vec, _mm256_mul_pd(delta, delta));
+    }
+
+    alignas(32) double m2s[4];
+    _mm256_store_pd(m2s, m2_vec);
+    result.m2 = (m2s[0] + m2s[1]) + (m2s[2] + m2s[3]);
+    finish_m2_scalar(data, i, n, mean, result.m2);
+    return result;
+}
+
+__attribute__((target("avx512f")))
+static Int_Block_Summary summarize_avx512(const int* data, size_t n) {
+    __m512i sum_low = _mm512_setzero_si512();
+    __m512i sum_high = _mm512_setzero_si512();
+    __m512i min_vec = _mm512_set1_epi32(data[0]);
+    __m512i max_vec = min_vec;
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512(data + i);
+        sum_low = _mm512_add_epi64(sum_low, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)));
+        sum_high = _mm512_add_epi64(sum_high, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1)));
+        min_vec = _mm512_min_epi32(min_vec, x);
+        max_vec = _mm512_max_epi32(max_vec, x);
+    }
+
+    Int_Block_Summary result{
+        _mm512_reduce_add_epi64(_mm512_add_epi64(sum_low, sum_high)),
+        _mm512_reduce_min_epi32(min_vec),
+        _mm512_reduce_max_epi32(max_vec),
+        0.0
+    };
+    for (; i < n; i++) {
+        result.sum += data[i];
+        result.min = std::min(result.min, data[i]);
+        result.max = std::max(result.max, data[i]);
+    }
+
+    double mean = (double)result.sum / n;
+    __m512d mean_vec = _mm512_set1_pd(mean);
+    __m512d m2_vec = _mm512_setzero_pd();
+
+    i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m512d delta = _mm512_sub_pd(_mm512_cvtepi32_pd(x), mean_vec);
+        m2_vec = _mm512_add_pd(m2_vec, _mm512_mul_pd(delta, delta));
+    }
+
+    result.m2 = _mm512_reduce_add_pd(m2_vec);
+    finish_m2_scalar(data, i, n, mean, result.m2);
+    return result;
+}
+
+#endif
+
+using Int_Kernel = Int_Block_Summary (*)(const int*, size_t);
+
+struct Int_Kernel_Choice {
+    Int_Kernel kernel;
+    const char* name;
+};
+
+static Int_Kernel_Choice choose_int_kernel() {
+#ifdef STATISTICS_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return {summarize_avx512, "avx512f"};
+    if (__builtin_cpu_supports("avx2")) return {summarize_avx2, "avx2"};
+#endif
+    return {summarize_scalar, "scalar"};
+}
+
+static const Int_Kernel_Choice& int_kernel() {
+    static const Int_Kernel_Choice choice = choose_int_kernel();
+    return choice;
+}
+
+Int_Block_Summary summarize_int_block(const int* data, size_t n) {
+    return int_kernel().kernel(data, n);
+}
+
+const char* get_int_kernel_name() {
+    return int_kernel().name;
+}
@@ -2,24 +2,31 @@
 #include "UniquePtr.hpp"
 #include "SharedPtr.hpp"
 #include "ReadOnlyStream.hpp"
-#include "RunningMedian.hpp"
+#include "PipelineStatistics.hpp"
 #include "OperationParser.hpp"
 #include "BinaryTree.hpp"
 #include "LazyInit.hpp"
 #include "IntegerInput.hpp"
+#include "WriteOnlyStream.hpp"
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 
 int main() {
     
+    // замеры стадий включаются переменной LAB1_PROFILE или пунктом меню
+    Pipeline_Profiler::set_enabled(std::getenv("LAB1_PROFILE") != nullptr);
+
     auto lazy_seq = init_new_lazy_seq();
     auto stream = my::make_shared<Lazy_Read_Only_Stream<int>>(lazy_seq);
     auto lazy_stream = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream));
-    Running_Median<int> median;
+    // квантили по эскизу, точные на дереве - переменной LAB1_EXACT_QUANTILES
+    Quantile_Mode quantile_mode = std::getenv("LAB1_EXACT_QUANTILES") ? quantile_exact : quantile_sketch;
+    Pipeline_Statistics<int> statistics(lazy_stream, 8192, quantile_mode); // по прочитанному префиксу, переживает правки конвейера
     
     std::cout << std::endl;
     
-    bool changed = false;
     size_t current_index = 0;
     bool running = true;
     while (running) {
@@ -36,6 +43,9 @@ int main() {
                       << "7.Read next N\n"
                       << "8.Reset index\n"
                       << "9.Show statistics\n"
+                      << "10.Show pipeline\n"
+                      << "11.Export first N to file\n"
+                      << "12.Toggle profiling\n"
                       << "0.Exit\n";
     
             int option = get_integer_input("Your choice: ");
@@ -45,7 +55,7 @@ int main() {
                     auto appendable = init_new_lazy_seq();
                     lazy_stream = lazy_stream->append(appendable);
                     std::cout << "Succes append\n";
-                    changed = true;
+                    statistics.rebind(lazy_stream);
                     break;
                 }
     
@@ -53,7 +63,7 @@ int main() {
                     auto prepandable = init_new_lazy_seq();
                     lazy_stream = lazy_stream->prepend(prepandable);
                     std::cout << "Succes prepend\n";
-                    changed = true;
+                    statistics.rebind(lazy_stream);
                     break;
                 }
     
@@ -63,7 +73,7 @@ int main() {
                     auto insertable = init_new_lazy_seq();
                     lazy_stream = lazy_stream->insert_at(index, insertable);
                     std::cout << "Succes insert\n";
-                    changed = true;
+                    statistics.rebind(lazy_stream);
                     break;
                 }
 
@@ -75,7 +85,7 @@ int main() {
 
                     auto func = Map_Parser<int>::parse(operation);
                     lazy_stream = lazy_stream->map(func);
-                    changed = true;
+                    statistics.rebind(lazy_stream);
                     break;
                 }
 
@@ -86,7 +96,7 @@ int main() {
 
                     auto func = Where_Parser<int>::parse(operation);
                     lazy_stream = lazy_stream->where(func);
-                    changed = true;
+                    statistics.rebind(lazy_stream);
                     break;
                 }
     
@@ -94,7 +104,7 @@ int main() {
                     std::cout << "Readed:\n";
 
                     int element = lazy_stream->get(current_index++);
-                    median.add(element);
+                    statistics.advance_to(current_index);
 
                     std::cout << "[" << current_index - 1 << "]: ";
                     std::cout << element << std::endl;
@@ -108,11 +118,11 @@ int main() {
                     std::cout << "Readed:\n";
                     while (lazy_stream->has_next() && i < elements_count) {
                         int element = lazy_stream->get(current_index++);
-                        median.add(element);
+                        statistics.advance_to(current_index);
                         i++;
 
                         std::cout << "[" << current_index - 1 << "]: ";
-                        std::cout << element << std::endl;
+                        std::cout << element << '\n';
                     }
 
                     if (i < elements_count) 
@@ -126,21 +136,68 @@ int main() {
                     break;
 
                 case 9: {
-                    if (changed) {
-                        changed = false;
-                        median.clear();
-
-                        int i = 0;
-                        while (lazy_stream->has_next() && i <= current_index) {
-                            median.add(lazy_stream->get(i++));
-                        }
+                    int mode = get_integer_input("1.Median\n2.Quantiles\n3.Summary\n4.Distinct values\nYour choice: ");
+                    if (mode == 4) {
+                        const auto& distinct = statistics.get_distinct();
+                        std::cout << "Distinct: ~" << (long long)std::llround(distinct.estimate()) << '\n'
+                                  << "Error: +-" << distinct.get_error() * 100 << "%, "
+                                  << distinct.get_memory_usage() << " bytes" << std::endl;
+                        break;
+                    }
+
+                    if (mode == 3) {
+                        const auto& summary = statistics.get_summary();
+                        std::cout << "Count: " << summary.get_count() << '\n';
+                        if (summary.is_sum_overflowed()) std::cout << "Sum: ~" << summary.get_sum_approx() << '\n';
+                        else std::cout << "Sum: " << summary.get_sum() << '\n';
+                        std::cout << "Mean: " << summary.get_mean() << '\n'
+                                  << "Std dev: " << summary.get_stddev() << '\n'
+                                  << "Min: " << summary.get_min() << '\n'
+                                  << "Max: " << summary.get_max() << std::endl;
+                        break;
+                    }
+
+                    if (mode == 2) {
+                        std::cout << "Median: " << statistics.get_quantile(0.5) << '\n'
+                                  << "P90: " << statistics.get_quantile(0.9) << '\n'
+                                  << "P99: " << statistics.get_quantile(0.99) << '\n';
+                    } else {
+                        std::cout << "Median: " << statistics.get_quantile(0.5) << '\n';
                     }
 
-                    std::cout << "Median: ";
-                    std::cout << median.get_median() << std::endl;
+                    if (statistics.get_mode() == quantile_sketch) {
+                        const auto& sketch = statistics.get_sketch();
+                        std::cout << "Rank error: +-" << sketch.get_error() * 100 << "%, "
+                                  << sketch.get_memory_usage() << " bytes\n";
+                    }
+                    std::cout << std::flush;
                     break;
                 }
     
+                case 10:
+                    lazy_stream->dump_pipeline();
+                    break;
+
+                case 11: {
+                    int elements_count = get_integer_input("Enter N: ");
+                    if (elements_count < 0)
+                        throw std::invalid_argument("N must be non-negative");
+
+                    std::cout << "Enter path:\n";
+                    std::string path;
+                    std::getline(std::cin, path);
+
+                    Text_Write_Stream<int> sink(path);
+                    size_t written = lazy_stream->drain_to(sink, elements_count);
+                    std::cout << "Exported " << written << " elements\n";
+                    break;
+                }
+
+                case 12:
+                    Pipeline_Profiler::set_enabled(!Pipeline_Profiler::is_enabled());
+                    std::cout << "Profiling " << (Pipeline_Profiler::is_enabled() ? "on" : "off") << '\n';
+                    break;
+
                 case 0:
                     running = false;
                     break;
@@ -0,0 +1,363 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "BinaryTree.hpp"
+#include "StaticSearchTree.hpp"
+
+template <typename T>
+static std::vector<T> collect(BinaryTree<T>& tree)
+{
+    std::vector<T> result;
+    auto it = tree.iterator();
+    while (it.has_next()) result.push_back(it.next());
+    return result;
+}
+
+// предельная высота AVL-дерева из n узлов
+static int avl_height_limit(size_t n)
+{
+    return (int)(1.45 * std::log2((double)n + 2));
+}
+
+TEST(BinaryTreeTests, SortedInsertStaysBalanced)
+{
+    BinaryTree<int> tree;
+    const int n = 100000;
+    for (int i = 0; i < n; i++) tree.add(i);
+
+    EXPECT_LE(tree.get_height(), avl_height_limit(n));
+
+    auto values = collect(tree);
+    ASSERT_EQ(values.size(), (size_t)n);
+    for (int i = 0; i < n; i++) EXPECT_EQ(values[i], i);
+}
+
+TEST(BinaryTreeTests, DuplicatesAreIgnored)
+{
+    BinaryTree<int> tree;
+    for (int i = 0; i < 5; i++) {
+        tree.add(3);
+        tree.add(1);
+    }
+
+    EXPECT_EQ(collect(tree), (std::vector<int>{1, 3}));
+}
+
+TEST(BinaryTreeTests, RemoveKeepsOrderAndBalance)
+{
+    BinaryTree<int> tree;
+    std::set<int> expected;
+    std::mt19937 rng(7);
+
+    for (int i = 0; i < 20000; i++) {
+        int value = (int)(rng() % 5000);
+        if (rng() % 3 == 0 && expected.count(value)) {
+            tree.remove(value);
+            expected.erase(value);
+        } else {
+            tree.add(value);
+            expected.insert(value);
+        }
+    }
+
+    EXPECT_EQ(collect(tree), std::vector<int>(expected.begin(), expected.end()));
+    EXPECT_LE(tree.get_height(), avl_height_limit(expected.size()));
+
+    for (int value : std::vector<int>(expected.begin(), expected.end())) tree.remove(value);
+    EXPECT_EQ(tree.get_height(), 0);
+    EXPECT_TRUE(collect(tree).empty());
+}
+
+TEST(BinaryTreeTests, RemoveMissingThrows)
+{
+    BinaryTree<int> tree;
+    tree.add(1);
+
+    EXPECT_THROW(tree.remove(2), std::runtime_error);
+}
+
+TEST(BinaryTreeTests, Contains)
+{
+    BinaryTree<int> tree;
+    for (int i = 0; i < 100; i += 2) tree.add(i);
+
+    EXPECT_TRUE(tree.contains(42));
+    EXPECT_FALSE(tree.contains(43));
+}
+
+TEST(BinaryTreeTests, ExtractSubtree)
+{
+    BinaryTree<int> tree;
+    for (int i = 1; i <= 7; i++) tree.add(i);
+
+    // после поворотов корень - 4, его левое поддерево 1..3
+    BinaryTree<int>* subtree = tree.extract_subtree(2);
+    EXPECT_EQ(collect(*subtree), (std::vector<int>{1, 2, 3}));
+    delete subtree;
+
+    EXPECT_THROW(tree.extract_subtree(10), std::runtime_error);
+}
+
+TEST(BinaryTreeTests, DestroyLargeTree)
+{
+    BinaryTree<int>* tree = new BinaryTree<int>();
+    for (int i = 1000000; i > 0; i--) tree->add(i);
+
+    EXPECT_LE(tree->get_height(), avl_height_limit(1000000));
+    delete tree;
+}
+
+// дерево 4(2(1,3),6(5,7)) после вставки 1..7
+static void fill_seven(BinaryTree<int>& tree)
+{
+    for (int i = 1; i <= 7; i++) tree.add(i);
+}
+
+TEST(BinaryTreeTests, PreOrderTraversal)
+{
+    BinaryTree<int> tree(new PreOrderTraversal<int>());
+    fill_seven(tree);
+
+    EXPECT_EQ(collect(tree), (std::vector<int>{4, 2, 1, 3, 6, 5, 7}));
+}
+
+TEST(BinaryTreeTests, PostOrderTraversal)
+{
+    BinaryTree<int> tree(new PostOrderTraversal<int>());
+    fill_seven(tree);
+
+    EXPECT_EQ(collect(tree), (std::vector<int>{1, 3, 2, 5, 7, 6, 4}));
+}
+
+TEST(BinaryTreeTests, TraversalsVisitEveryNodeOnce)
+{
+    std::mt19937 rng(11);
+    std::set<int> expected;
+    for (int i = 0; i < 3000; i++) expected.insert((int)(rng() % 10000));
+
+    std::vector<TreeTraversal<int>*> traversals = {
+        new InOrderTraversal<int>(), new PreOrderTraversal<int>(), new PostOrderTraversal<int>()
+    };
+    for (TreeTraversal<int>* traversal : traversals) {
+        BinaryTree<int> tree(traversal);
+        for (int value : expected) tree.add(value);
+
+        auto values = collect(tree);
+        EXPECT_EQ(values.size(), expected.size());
+        std::sort(values.begin(), values.end());
+        EXPECT_EQ(values, std::vector<int>(expected.begin(), expected.end()));
+    }
+}
+
+TEST(BinaryTreeTests, IteratorIsLazy)
+{
+    BinaryTree<int> tree;
+    for (int i = 0; i < 1000; i++) tree.add(i);
+
+    auto it = tree.iterator();
+    EXPECT_EQ(it.next(), 0);
+    EXPECT_EQ(it.next(), 1);
+
+    // смена обхода у дерева не задевает начатый итератор
+    tree.set_traversal(new PreOrderTraversal<int>());
+    EXPECT_EQ(it.next(), 2);
+
+    it.reset();
+    EXPECT_EQ(it.next(), 0);
+    EXPECT_EQ(it.get_size(), 1000u);
+    EXPECT_EQ(it.get_at(999), 999);
+    EXPECT_THROW(it.get_at(1000), std::out_of_range);
+}
+
+TEST(BinaryTreeTests, EmptyTreeIterator)
+{
+    BinaryTree<int> tree;
+    auto it = tree.iterator();
+
+    EXPECT_FALSE(it.has_next());
+    EXPECT_EQ(it.get_size(), 0u);
+    EXPECT_THROW(it.next(), std::out_of_range);
+}
+
+TEST(BinaryTreeTests, SizeFollowsAddAndRemove)
+{
+    BinaryTree<int> tree;
+    for (int i = 0; i < 100; i++) tree.add(i % 50);
+    EXPECT_EQ(tree.get_size(), 50u);
+
+    tree.remove(10);
+    EXPECT_EQ(tree.get_size(), 49u);
+
+    BinaryTree<int>* subtree = tree.extract_subtree(tree.iterator().get_at(0));
+    EXPECT_EQ(subtree->get_size(), 1u);
+    delete subtree;
+}
+
+TEST(BinaryTreeTests, ClearAndReuse)
+{
+    BinaryTree<int> tree;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 10000; i++) tree.add(i * 7 % 10007);
+        EXPECT_EQ(tree.get_size(), 10000u);
+
+        tree.clear();
+        EXPECT_EQ(tree.get_size(), 0u);
+        EXPECT_EQ(tree.get_height(), 0);
+        EXPECT_FALSE(tree.iterator().has_next());
+    }
+
+    tree.add(5);
+    EXPECT_TRUE(tree.contains(5));
+    EXPECT_FALSE(tree.contains(0));
+}
+
+TEST(BinaryTreeTests, ClearNonTrivialData)
+{
+    BinaryTree<std::string> tree;
+    for (int i = 0; i < 1000; i++) tree.add(std::string(40, 'a') + std::to_string(i));
+
+    tree.remove(std::string(40, 'a') + "500");
+    EXPECT_EQ(tree.get_size(), 999u);
+
+    tree.clear();
+    tree.add("x");
+    EXPECT_EQ(collect(tree), (std::vector<std::string>{"x"}));
+}
+
+TEST(NodePoolTests, ReusesFreedSlots)
+{
+    Node_Pool<TreeNode<int>> pool;
+    TreeNode<int>* first = pool.create(1);
+    pool.destroy(first);
+
+    TreeNode<int>* second = pool.create(2);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(second->data, 2);
+    EXPECT_EQ(pool.get_live_count(), 1u);
+}
+
+TEST(NodePoolTests, ReleaseAllKeepsOneBlock)
+{
+    Node_Pool<TreeNode<int>> pool;
+    for (int i = 0; i < 100000; i++) pool.create(i);
+    EXPECT_GT(pool.get_block_count(), 1u);
+
+    pool.release_all();
+    EXPECT_EQ(pool.get_block_count(), 1u);
+    EXPECT_EQ(pool.get_live_count(), 0u);
+
+    for (int i = 0; i < 4096; i++) pool.create(i);
+    EXPECT_EQ(pool.get_block_count(), 1u);
+}
+
+TEST(StaticSearchTreeTests, LowerBoundMatchesStd)
+{
+    std::mt19937 rng(5);
+    for (size_t n : {0, 1, 2, 3, 7, 8, 15, 16, 100, 1023, 1024, 5000}) {
+        std::vector<int> values(n);
+        for (int& value : values) value = (int)(rng() % 3000);
+        std::sort(values.begin(), values.end());
+
+        Static_Search_Tree<int> tree(values.data(), n);
+        ASSERT_EQ(tree.get_size(), n);
+
+        for (int query = -1; query <= 3001; query++) {
+            auto expected = std::lower_bound(values.begin(), values.end(), query);
+            const int* found = tree.lower_bound(query);
+
+            if (expected == values.end()) {
+                EXPECT_EQ(found, nullptr);
+            } else {
+                ASSERT_NE(found, nullptr);
+                EXPECT_EQ(*found, *expected);
+            }
+            EXPECT_EQ(tree.contains(query), std::binary_search(values.begin(), values.end(), query));
+        }
+    }
+}
+
+TEST(StaticSearchTreeTests, BuildFromBinaryTree)
+{
+    BinaryTree<int> source(new PostOrderTraversal<int>());
+    std::set<int> expected;
+    std::mt19937 rng(9);
+    for (int i = 0; i < 10000; i++) {
+        int value = (int)(rng() % 100000);
+        source.add(value);
+        expected.insert(value);
+    }
+
+    Static_Search_Tree<int> tree(source);
+    EXPECT_EQ(tree.get_size(), expected.size());
+    for (int query = 0; query < 100000; query += 7) {
+        EXPECT_EQ(tree.contains(query), expected.count(query) == 1);
+    }
+}
+
+TEST(StaticSearchTreeTests, BuildFromArraySequence)
+{
+    int data[] = {1, 3, 3, 5, 8, 13, 21};
+    Array_Sequence<int> sorted(data, 7);
+
+    Static_Search_Tree<int> tree(sorted);
+    EXPECT_EQ(tree.get_size(), 7u);
+    EXPECT_EQ(*tree.lower_bound(4), 5);
+    EXPECT_EQ(*tree.lower_bound(3), 3);
+    EXPECT_EQ(tree.lower_bound(22), nullptr);
+    EXPECT_TRUE(tree.contains(21));
+    EXPECT_FALSE(tree.contains(2));
+}
+
+TEST(StaticSearchTreeTests, UnsortedInputThrows)
+{
+    int data[] = {1, 5, 3};
+    Array_Sequence<int> unsorted(data, 3);
+
+    EXPECT_THROW(Static_Search_Tree<int>{unsorted}, std::invalid_argument);
+    EXPECT_THROW(Static_Search_Tree<int>(data, 3), std::invalid_argument);
+}
+
+TEST(StaticSearchTreeTests, NonTrivialKeys)
+{
+    BinaryTree<std::string> source;
+    for (const char* word : {"pear", "apple", "plum", "fig", "kiwi"}) source.add(word);
+
+    Static_Search_Tree<std::string> tree(source);
+    EXPECT_TRUE(tree.contains("fig"));
+    EXPECT_FALSE(tree.contains("grape"));
+    EXPECT_EQ(*tree.lower_bound("grape"), "kiwi");
+}
+
+TEST(StaticSearchTreeTests, CopyKeepsAlignment)
+{
+    std::vector<int> values(1000);
+    for (int i = 0; i < 1000; i++) values[i] = i * 2;
+
+    Static_Search_Tree<int> tree(values.data(), values.size());
+    EXPECT_TRUE(tree.is_aligned());
+
+    // копии в новых буферах, при росте вектора они ещё и перемещаются
+    std::vector<Static_Search_Tree<int>> copies;
+    for (int i = 0; i < 8; i++) copies.push_back(tree);
+
+    for (const auto& copy : copies) {
+        EXPECT_TRUE(copy.is_aligned());
+        EXPECT_TRUE(copy.contains(998));
+        EXPECT_FALSE(copy.contains(999));
+    }
+
+    Static_Search_Tree<int> assigned;
+    assigned = tree;
+    EXPECT_TRUE(assigned.is_aligned());
+    EXPECT_EQ(*assigned.lower_bound(3), 4);
+
+    Static_Search_Tree<int> moved(std::move(assigned));
+    EXPECT_TRUE(moved.is_aligned());
+    EXPECT_EQ(moved.get_size(), 1000u);
+    EXPECT_EQ(assigned.get_size(), 0u);
+    EXPECT_FALSE(assigned.contains(4));
+}
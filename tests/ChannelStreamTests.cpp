@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+#include "LazySequence.hpp"
+#include "ChannelStream.hpp"
+
+TEST(ChannelStream, TryVariantsRespectCapacity)
+{
+    Channel_Stream<int> channel(3);
+    EXPECT_EQ(channel.get_capacity(), 4);
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(channel.try_push(i));
+    EXPECT_FALSE(channel.try_push(4));
+
+    int item = -1;
+    EXPECT_TRUE(channel.try_pop(item));
+    EXPECT_EQ(item, 0);
+    EXPECT_TRUE(channel.try_push(4));
+
+    int out[8];
+    EXPECT_EQ(channel.try_pop(out, 8), 4);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[3], 4);
+    EXPECT_FALSE(channel.try_pop(item));
+}
+
+TEST(ChannelStream, CloseEndsStream)
+{
+    Channel_Stream<int> channel(8);
+    int items[] = {1, 2, 3};
+    channel.push(items, 3);
+    channel.close();
+
+    EXPECT_THROW(channel.push(4), std::runtime_error);
+    EXPECT_FALSE(channel.is_end_of_stream());
+
+    int out[8];
+    EXPECT_EQ(channel.read(out, 8), 3);
+    EXPECT_TRUE(channel.is_end_of_stream());
+    EXPECT_EQ(channel.read(out, 8), 0);
+    EXPECT_THROW(channel.read(), std::runtime_error);
+}
+
+TEST(ChannelStream, ManyProducersManyConsumers)
+{
+    const int producers = 4;
+    const int consumers = 3;
+    const int per_producer = 20000;
+
+    Channel_Stream<int> channel(64);
+
+    std::vector<std::thread> writers;
+    for (int p = 0; p < producers; ++p) {
+        writers.emplace_back([&channel, p]() {
+            int batch[16];
+            for (int i = 0; i < per_producer; i += 16) {
+                for (int j = 0; j < 16; ++j) batch[j] = p * per_producer + i + j;
+                channel.push(batch, 16);
+            }
+        });
+    }
+
+    std::vector<std::vector<int>> seen(consumers, std::vector<int>());
+    std::vector<std::thread> readers;
+    for (int c = 0; c < consumers; ++c) {
+        readers.emplace_back([&channel, &seen, c]() {
+            int batch[32];
+            size_t count = 0;
+            while ((count = channel.read(batch, 32)) > 0)
+                seen[c].insert(seen[c].end(), batch, batch + count);
+        });
+    }
+
+    for (auto& writer : writers) writer.join();
+    channel.close();
+    for (auto& reader : readers) reader.join();
+
+    std::vector<int> hits(producers * per_producer, 0);
+    for (const auto& items : seen)
+        for (int item : items) hits[item]++;
+
+    for (int hit : hits)
+        EXPECT_EQ(hit, 1);
+}
+
+static double thread_cpu_seconds()
+{
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+TEST(ChannelStream, IdleReaderSleeps)
+{
+    Channel_Stream<int> channel(8);
+
+    double cpu = 0;
+    int item = -1;
+    std::thread reader([&]() {
+        double start = thread_cpu_seconds();
+        item = channel.read();
+        EXPECT_TRUE(channel.is_end_of_stream());
+        cpu = thread_cpu_seconds() - start;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    channel.push(42);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    channel.close();
+    reader.join();
+
+    EXPECT_EQ(item, 42);
+    EXPECT_LT(cpu, 0.05);
+}
+
+TEST(ChannelStream, FullWriterSleepsUntilRead)
+{
+    Channel_Stream<int> channel(2);
+    channel.push(1);
+    channel.push(2);
+
+    std::thread writer([&]() { channel.push(3); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(channel.read(), 1);
+    writer.join();
+
+    EXPECT_EQ(channel.read(), 2);
+    EXPECT_EQ(channel.read(), 3);
+}
+
+TEST(ChannelStream, FeedsStreamGenerator)
+{
+    auto channel = my::make_shared<Channel_Stream<int>>(16);
+
+    std::thread producer([channel]() {
+        for (int i = 0; i < 1000; ++i)
+            channel->push(i);
+        channel->close();
+    });
+
+    auto lazy = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(channel));
+    auto even = lazy->where([](int x) { return x % 2 == 0; });
+
+    EXPECT_EQ(even->get(499), 998);
+    EXPECT_FALSE(even->has_next());
+
+    producer.join();
+}
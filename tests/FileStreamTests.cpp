@@ -0,0 +1,351 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "LazySequence.hpp"
+#include "MappedFileStream.hpp"
+#include "PrefetchingFileStream.hpp"
+#include "TextNumberStream.hpp"
+#include "WriteOnlyStream.hpp"
+
+static std::string write_binary_file(const std::string& name, const int* data, size_t count)
+{
+    std::string path = ::testing::TempDir() + name;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data), count * sizeof(int));
+    return path;
+}
+
+static std::string write_text_file(const std::string& name, const std::string& text)
+{
+    std::string path = ::testing::TempDir() + name;
+    std::ofstream out(path, std::ios::trunc);
+    out << text;
+    return path;
+}
+
+TEST(MappedFileStream, ReadsWholeFile)
+{
+    int data[] = {1, 2, 3, 4};
+    auto path = write_binary_file("mapped_read.bin", data, 4);
+
+    Mapped_File_Stream<int> stream(path);
+
+    EXPECT_EQ(stream.get_size(), 4);
+    EXPECT_TRUE(stream.is_can_seek());
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(stream.read(), data[i]);
+
+    EXPECT_TRUE(stream.is_end_of_stream());
+    EXPECT_THROW(stream.read(), std::runtime_error);
+}
+
+TEST(MappedFileStream, SeekAndZeroCopyAccess)
+{
+    int data[] = {10, 20, 30, 40, 50};
+    auto path = write_binary_file("mapped_seek.bin", data, 5);
+
+    Mapped_File_Stream<int> stream(path);
+
+    EXPECT_TRUE(stream.seek(3));
+    EXPECT_EQ(stream.read(), 40);
+    EXPECT_EQ(stream.get_position(), 4);
+
+    EXPECT_TRUE(stream.seek(5));
+    EXPECT_TRUE(stream.is_end_of_stream());
+    EXPECT_THROW(stream.seek(6), std::runtime_error);
+
+    EXPECT_EQ(stream.get_data()[1], 20);
+}
+
+TEST(MappedFileStream, BulkAndViewReads)
+{
+    int data[] = {1, 2, 3, 4, 5};
+    auto path = write_binary_file("mapped_bulk.bin", data, 5);
+
+    Mapped_File_Stream<int> stream(path);
+
+    int out[3];
+    EXPECT_EQ(stream.read(out, 3), 3);
+    EXPECT_EQ(out[2], 3);
+
+    Stream_View<int> view = stream.read_view(10);
+    EXPECT_EQ(view.size, 2);
+    EXPECT_EQ(view.data, stream.get_data() + 3);
+    EXPECT_TRUE(stream.is_end_of_stream());
+}
+
+TEST(MappedFileStream, EmptyFile)
+{
+    auto path = write_binary_file("mapped_empty.bin", nullptr, 0);
+
+    Mapped_File_Stream<int> stream(path);
+
+    EXPECT_EQ(stream.get_size(), 0);
+    EXPECT_TRUE(stream.is_end_of_stream());
+
+    int out[4];
+    EXPECT_EQ(stream.read(out, 4), 0u);
+    EXPECT_TRUE(stream.read_view(4).empty());
+}
+
+TEST(MappedFileStream, MissingFileThrows)
+{
+    EXPECT_THROW(Mapped_File_Stream<int>(::testing::TempDir() + "no_such_file.bin"), std::runtime_error);
+}
+
+TEST(MappedFileStream, FeedsStreamGenerator)
+{
+    int data[] = {1, 2, 3, 4, 5, 6};
+    auto path = write_binary_file("mapped_generator.bin", data, 6);
+
+    auto stream = my::make_shared<Mapped_File_Stream<int>>(path);
+    auto lazy = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream));
+    auto odd = lazy->where([](int x) { return x % 2 == 1; });
+
+    EXPECT_EQ(odd->get(0), 1);
+    EXPECT_EQ(odd->get(2), 5);
+    EXPECT_FALSE(odd->has_next());
+}
+
+TEST(PrefetchingFileStream, ReadsAcrossBlocks)
+{
+    std::vector<int> data(50000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (int)i * 3;
+    auto path = write_binary_file("prefetch_blocks.bin", data.data(), data.size());
+
+    Prefetching_File_Stream<int> stream(path, 4096, 3);
+    EXPECT_EQ(stream.get_size(), 50000);
+
+    EXPECT_EQ(stream.read(), 0);
+    EXPECT_EQ(stream.read(), 3);
+
+    std::vector<int> out(data.size());
+    EXPECT_EQ(stream.read(out.data() + 2, out.size()), 49998);
+    for (size_t i = 2; i < data.size(); ++i)
+        ASSERT_EQ(out[i], data[i]);
+
+    EXPECT_TRUE(stream.is_end_of_stream());
+    EXPECT_THROW(stream.read(), std::runtime_error);
+}
+
+TEST(PrefetchingFileStream, SeekAndViews)
+{
+    std::vector<int> data(20000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (int)i;
+    auto path = write_binary_file("prefetch_seek.bin", data.data(), data.size());
+
+    Prefetching_File_Stream<int> stream(path, 4096, 2, true);
+
+    EXPECT_TRUE(stream.seek(10000));
+    EXPECT_EQ(stream.read(), 10000);
+
+    Stream_View<int> view = stream.read_view(100000);
+    EXPECT_EQ(view.size, 3 * 4096 - 10001);
+    EXPECT_EQ(view.data[0], 10001);
+
+    view = stream.read_view(10);
+    EXPECT_EQ(view.size, 10);
+    EXPECT_EQ(view.data[0], 3 * 4096);
+
+    EXPECT_TRUE(stream.seek(20000));
+    EXPECT_TRUE(stream.is_end_of_stream());
+    EXPECT_THROW(stream.seek(20001), std::runtime_error);
+
+    stream.reset();
+    EXPECT_EQ(stream.read(), 0);
+}
+
+TEST(PrefetchingFileStream, FeedsStreamGenerator)
+{
+    std::vector<int> data(10000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = (int)i;
+    auto path = write_binary_file("prefetch_generator.bin", data.data(), data.size());
+
+    auto stream = my::make_shared<Prefetching_File_Stream<int>>(path, 4096);
+    auto lazy = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream));
+    auto odd = lazy->where([](int x) { return x % 2 == 1; });
+
+    EXPECT_EQ(odd->get(4999), 9999);
+    EXPECT_FALSE(odd->has_next());
+}
+
+TEST(TextNumberStream, ParsesMixedSeparators)
+{
+    auto path = write_text_file("text_mixed.txt", "  1 -2\n3\t\t40\r\n  -500\n\n");
+
+    Text_Number_Stream<int> stream(path);
+
+    EXPECT_FALSE(stream.is_can_seek());
+    EXPECT_EQ(stream.read(), 1);
+    EXPECT_EQ(stream.read(), -2);
+    EXPECT_EQ(stream.read(), 3);
+    EXPECT_EQ(stream.read(), 40);
+    EXPECT_FALSE(stream.is_end_of_stream());
+    EXPECT_EQ(stream.read(), -500);
+    EXPECT_TRUE(stream.is_end_of_stream());
+    EXPECT_EQ(stream.get_position(), 5);
+    EXPECT_THROW(stream.read(), std::runtime_error);
+}
+
+TEST(TextNumberStream, BulkRead)
+{
+    auto path = write_text_file("text_bulk.txt", "1 2 3\n4 5");
+
+    Text_Number_Stream<int> stream(path);
+
+    int out[4];
+    EXPECT_EQ(stream.read(out, 4), 4);
+    EXPECT_EQ(out[3], 4);
+    EXPECT_EQ(stream.read(out, 4), 1);
+    EXPECT_EQ(out[0], 5);
+    EXPECT_TRUE(stream.read_view(4).empty());
+}
+
+TEST(TextNumberStream, InvalidNumberThrows)
+{
+    auto path = write_text_file("text_invalid.txt", "1 2x 3");
+
+    Text_Number_Stream<int> stream(path);
+
+    EXPECT_EQ(stream.read(), 1);
+    EXPECT_THROW(stream.read(), std::runtime_error);
+}
+
+TEST(TextNumberStream, SizeIsUnknown)
+{
+    auto path = write_text_file("text_size.txt", "1 2 3");
+
+    Text_Number_Stream<int> stream(path);
+    stream.read();
+
+    EXPECT_EQ(stream.get_position(), 1u);
+    EXPECT_EQ(stream.get_size(), Read_Only_Stream<int>::unknown_size);
+}
+
+TEST(TextNumberStream, ManyNumbersAcrossBuffers)
+{
+    std::string text;
+    const int count = 300000;
+    for (int i = 0; i < count; ++i)
+        text += std::to_string(i * 7) + (i % 10 == 9 ? "\n" : " ");
+    auto path = write_text_file("text_many.txt", text);
+
+    Text_Number_Stream<int> stream(path);
+
+    long long sum = 0;
+    int read = 0;
+    while (!stream.is_end_of_stream()) {
+        EXPECT_EQ(stream.read(), read * 7);
+        sum += read * 7;
+        read++;
+    }
+
+    EXPECT_EQ(read, count);
+
+    stream.reset();
+    EXPECT_EQ(stream.read(), 0);
+}
+
+TEST(TextNumberStream, FeedsStreamGenerator)
+{
+    auto path = write_text_file("text_generator.txt", "5 6 7");
+
+    auto stream = my::make_shared<Text_Number_Stream<int>>(path);
+    auto lazy = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream));
+
+    auto doubled = lazy->map<int>([](int x) { return x * 2; });
+
+    EXPECT_EQ(doubled->get(0), 10);
+    EXPECT_EQ(doubled->get(2), 14);
+    EXPECT_FALSE(doubled->has_next());
+}
+
+TEST(WriteOnlyStream, BinaryRoundTrip)
+{
+    std::string path = ::testing::TempDir() + "binary_sink.bin";
+    {
+        Binary_File_Write_Stream<int> sink(path);
+        int data[] = {7, 8, 9};
+        sink.write(data, 3);
+        sink.write(10);
+        EXPECT_EQ(sink.get_position(), 4);
+    }
+
+    Mapped_File_Stream<int> stream(path);
+    EXPECT_EQ(stream.get_size(), 4);
+    EXPECT_EQ(stream.get_data()[0], 7);
+    EXPECT_EQ(stream.get_data()[3], 10);
+}
+
+TEST(WriteOnlyStream, DrainLazySequenceToText)
+{
+    std::string path = ::testing::TempDir() + "text_sink.txt";
+
+    Array_Sequence<int> start;
+    start.append(1);
+    auto twice = [](const Sequence<int>& s) { return s.get(s.get_size() - 1) * 2 % 1000003; };
+    auto lazy = Lazy_Sequence<int>::create(start, 1, twice);
+
+    const size_t count = 10000;
+    {
+        Text_Write_Stream<int> sink(path);
+        EXPECT_EQ(lazy->drain_to(sink, count), count);
+    }
+
+    Text_Number_Stream<int> stream(path);
+    for (size_t i = 0; i < count; ++i)
+        EXPECT_EQ(stream.read(), lazy->get(i));
+    EXPECT_TRUE(stream.is_end_of_stream());
+}
+
+TEST(WriteOnlyStream, DrainStopsAtEndOfSequence)
+{
+    std::string path = ::testing::TempDir() + "text_sink_short.txt";
+
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 5; ++i)
+        seq.append(i);
+    auto lazy = Lazy_Sequence<int>::create(seq);
+
+    {
+        Text_Write_Stream<int> sink(path);
+        EXPECT_EQ(lazy->drain_to(sink, 100, 2), 3);
+    }
+
+    Text_Number_Stream<int> stream(path);
+    EXPECT_EQ(stream.read(), 2);
+    EXPECT_EQ(stream.read(), 3);
+    EXPECT_EQ(stream.read(), 4);
+    EXPECT_TRUE(stream.is_end_of_stream());
+}
+
+TEST(WriteOnlyStream, DrainDoesNotGrowHistory)
+{
+    std::string source = ::testing::TempDir() + "drain_source.bin";
+    {
+        Binary_File_Write_Stream<int> sink(source);
+        for (int i = 0; i < 10000; ++i)
+            sink.write(i * 3);
+    }
+
+    auto stream = my::make_shared<Mapped_File_Stream<int>>(source);
+    auto lazy = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream));
+    EXPECT_EQ(lazy->get(1), 3);
+
+    std::string path = ::testing::TempDir() + "drain_history.bin";
+    {
+        Binary_File_Write_Stream<int> sink(path);
+        EXPECT_EQ(lazy->drain_to(sink, 10000), 10000u);
+    }
+    EXPECT_EQ(lazy->get_materialized_count(), 2u);
+
+    // генератор возвращён туда, где остановилась история
+    EXPECT_EQ(lazy->get(2), 6);
+
+    Mapped_File_Stream<int> exported(path);
+    ASSERT_EQ(exported.get_size(), 10000u);
+    EXPECT_EQ(exported.get_data()[0], 0);
+    EXPECT_EQ(exported.get_data()[9999], 9999 * 3);
+}
@@ -2,6 +2,7 @@
 #include "LazySequence.hpp"
 #include "ArraySequence.hpp"
 #include "ReadOnlyStream.hpp"
+#include "TeeStream.hpp"
 
 TEST(LazyReadOnlyStream, ReadAdvancesPosition)
 {
@@ -63,7 +64,7 @@ TEST(LazyReadOnlyStream, SeekWithinMaterialized)
     EXPECT_EQ(stream.read(), 6);
 }
 
-TEST(LazyReadOnlyStream, SeekBeyondMaterializedThrows)
+TEST(LazyReadOnlyStream, SeekBeyondEndThrows)
 {
     Array_Sequence<int> seq;
     seq.append(1);
@@ -72,11 +73,58 @@ TEST(LazyReadOnlyStream, SeekBeyondMaterializedThrows)
     auto lazy = Lazy_Sequence<int>::create(seq);
     Lazy_Read_Only_Stream<int> stream(lazy);
 
-    EXPECT_THROW(stream.seek(1), std::runtime_error);
+    EXPECT_TRUE(stream.seek(1));
+    EXPECT_EQ(stream.read(), 2);
 
-    stream.read();
+    EXPECT_TRUE(stream.seek(2));
+    EXPECT_TRUE(stream.is_end_of_stream());
+
+    EXPECT_THROW(stream.seek(3), std::runtime_error);
+}
+
+TEST(LazyReadOnlyStream, SeekRandomAccessGeneratesNothing)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 1000; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    auto squares = lazy->map<int>([](int x) { return x * x; });
+    Lazy_Read_Only_Stream<int> stream(squares);
+
+    EXPECT_TRUE(stream.seek(900));
+    EXPECT_EQ(stream.read(), 810000);
+    EXPECT_EQ(stream.read(), 811801);
+
+    EXPECT_EQ(squares->get_materialized_count(), 0);
+    EXPECT_EQ(lazy->get_materialized_count(), 0);
+
+    EXPECT_TRUE(stream.seek(1000));
+    EXPECT_TRUE(stream.is_end_of_stream());
+}
+
+TEST(LazyReadOnlyStream, SeekGeneratesOnlyPrecedingElements)
+{
+    int generated = 0;
+
+    Array_Sequence<int> start;
+    start.append(0);
+    start.append(1);
+
+    auto rule = [&generated](const Array_Sequence<int>& seq) -> int {
+        ++generated;
+        size_t n = seq.get_size();
+        return seq.get(n - 1) + seq.get(n - 2);
+    };
+
+    auto lazy = Lazy_Sequence<int>::create(start, 2, rule);
+    Lazy_Read_Only_Stream<int> stream(lazy);
 
-    EXPECT_THROW(stream.seek(2), std::runtime_error);
+    EXPECT_TRUE(stream.seek(10));
+    EXPECT_EQ(generated, 8);
+
+    EXPECT_EQ(stream.read(), 55);
+    EXPECT_EQ(generated, 9);
 }
 
 TEST(LazyReadOnlyStream, GetSizeReturnsMaterializedCount)
@@ -134,3 +182,192 @@ TEST(LazyReadOnlyStream, DoesNotOverGenerate)
 
 
 
+TEST(LazyReadOnlyStream, BulkReadStopsAtEnd)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 5; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    Lazy_Read_Only_Stream<int> stream(lazy);
+
+    int out[4];
+    EXPECT_EQ(stream.read(out, 3), 3);
+    EXPECT_EQ(out[2], 2);
+    EXPECT_EQ(stream.get_position(), 3);
+
+    EXPECT_EQ(stream.read(out, 4), 2);
+    EXPECT_EQ(out[0], 3);
+    EXPECT_EQ(out[1], 4);
+    EXPECT_EQ(stream.read(out, 4), 0);
+}
+
+TEST(LazyReadOnlyStream, ReadViewBorrowsMaterializedData)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 5; ++i)
+        seq.append(i * 10);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    Lazy_Read_Only_Stream<int> stream(lazy);
+
+    stream.read();
+
+    Stream_View<int> view = stream.read_view(3);
+    ASSERT_EQ(view.size, 3);
+    EXPECT_EQ(view.data, lazy->get_materialized_data() + 1);
+    EXPECT_EQ(view.data[0], 10);
+    EXPECT_EQ(view.data[2], 30);
+    EXPECT_EQ(stream.get_position(), 4);
+    EXPECT_EQ(lazy->get_materialized_count(), 4);
+
+    EXPECT_EQ(stream.read_view(10).size, 1);
+    EXPECT_TRUE(stream.read_view(10).empty());
+}
+
+TEST(LazyReadOnlyStream, ReadViewStopsAtRequestedCount)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 10; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    lazy->get(9);
+
+    Lazy_Read_Only_Stream<int> stream(lazy);
+    stream.seek(2);
+
+    Stream_View<int> view = stream.read_view(3);
+    ASSERT_EQ(view.size, 3);
+    EXPECT_EQ(view.data[0], 2);
+    EXPECT_EQ(stream.get_position(), 5);
+}
+
+TEST(LazyReadOnlyStream, StreamGeneratorReadsInBlocks)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 10; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    auto stream = my::make_shared<Lazy_Read_Only_Stream<int>>(lazy);
+    auto generated = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream, 4));
+
+    EXPECT_EQ(generated->get(0), 0);
+    EXPECT_EQ(stream->get_position(), 4);
+
+    EXPECT_EQ(generated->get(9), 9);
+    EXPECT_FALSE(generated->has_next());
+    EXPECT_ANY_THROW(generated->get(10));
+}
+
+TEST(LazyReadOnlyStream, StreamGeneratorReadsOnlyDemanded)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 10; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    auto stream = my::make_shared<Lazy_Read_Only_Stream<int>>(lazy);
+    auto generated = Lazy_Sequence<int>::create(my::make_unique<Stream_Generator<int>>(stream));
+
+    EXPECT_EQ(generated->get(0), 0);
+    EXPECT_EQ(stream->get_position(), 1);
+
+    EXPECT_EQ(generated->get(2), 2);
+    EXPECT_EQ(stream->get_position(), 3);
+}
+
+TEST(LazyReadOnlyStream, BulkReadReportsErrorAfterPartialRead)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 10; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq)->map<int>([](const int& x) {
+        if (x == 5) throw std::runtime_error("Bad element");
+        return x;
+    });
+    Lazy_Read_Only_Stream<int> stream(lazy);
+
+    int out[10];
+    EXPECT_EQ(stream.read(out, 10), 5u);
+    EXPECT_EQ(out[4], 4);
+    EXPECT_FALSE(stream.is_end_of_stream());
+    EXPECT_THROW(stream.read(out, 10), std::runtime_error);
+}
+
+TEST(TeeStream, CursorsReadIndependently)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 100; ++i)
+        seq.append(i);
+
+    auto source = my::make_shared<Lazy_Read_Only_Stream<int>>(Lazy_Sequence<int>::create(seq));
+    auto tee = Tee_Stream<int>::create(source, 2, 8);
+
+    auto fast = tee->get_cursor(0);
+    auto slow = tee->get_cursor(1);
+    EXPECT_THROW(tee->get_cursor(1), std::runtime_error);
+
+    for (int i = 0; i < 50; ++i)
+        EXPECT_EQ(fast->read(), i);
+
+    EXPECT_EQ(slow->read(), 0);
+    EXPECT_EQ(slow->read(), 1);
+
+    int out[100];
+    EXPECT_EQ(fast->read(out, 100), 50);
+    EXPECT_EQ(out[0], 50);
+    EXPECT_EQ(out[49], 99);
+    EXPECT_TRUE(fast->is_end_of_stream());
+
+    EXPECT_EQ(slow->read(out, 100), 98);
+    EXPECT_EQ(out[0], 2);
+    EXPECT_EQ(out[97], 99);
+    EXPECT_TRUE(slow->is_end_of_stream());
+}
+
+TEST(TeeStream, BuffersOnlySkew)
+{
+    Array_Sequence<int> start;
+    start.append(0);
+    auto next = [](const Array_Sequence<int>& s) { return s.get(s.get_size() - 1) + 1; };
+
+    auto source = my::make_shared<Lazy_Read_Only_Stream<int>>(Lazy_Sequence<int>::create(start, 1, next));
+    auto tee = Tee_Stream<int>::create(source, 2, 16);
+
+    auto first = tee->get_cursor(0);
+    auto second = tee->get_cursor(1);
+
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(first->read(), i);
+        if (i >= 40) {
+            EXPECT_EQ(second->read(), i - 40);
+        }
+        EXPECT_LE(tee->get_buffered_count(), 40 + 2 * 16);
+    }
+}
+
+TEST(TeeStream, DetachedCursorDoesNotHoldData)
+{
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 1000; ++i)
+        seq.append(i);
+
+    auto source = my::make_shared<Lazy_Read_Only_Stream<int>>(Lazy_Sequence<int>::create(seq));
+    auto tee = Tee_Stream<int>::create(source, 2, 16);
+
+    auto reader = tee->get_cursor(0);
+    {
+        auto dropped = tee->get_cursor(1);
+        EXPECT_EQ(dropped->read(), 0);
+    }
+
+    while (!reader->is_end_of_stream()) {
+        Stream_View<int> view = reader->read_view(10);
+        EXPECT_FALSE(view.empty());
+    }
+
+    EXPECT_LE(tee->get_buffered_count(), 16);
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "LazySequence.hpp"
 #include "ArraySequence.hpp"
+#include "RollingStatistics.hpp"
+#include <cstring>
+#include <fstream>
+#include <limits>
 
 TEST(LazySequence, CreateFromSequence) {
     Array_Sequence<int> seq;
@@ -200,4 +204,240 @@ TEST(LazySequence, DoesNotOverGenerate)
 
     EXPECT_EQ(seq->get(3), 2);
     EXPECT_EQ(generated, 2);
-}
\ No newline at end of file
+}
+
+TEST(LazySequence, ProfilingCountsWhereScanning)
+{
+    Pipeline_Profiler::set_enabled(true);
+
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 10; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    auto big = lazy->where([](int x) { return x >= 8; });
+
+    EXPECT_EQ(big->get(0), 8);
+
+    Pipeline_Counters source = lazy->get_counters();
+    Pipeline_Counters filtered = big->get_counters();
+
+    EXPECT_EQ(filtered.produced, 1);
+    EXPECT_EQ(source.get_calls, 9);
+    EXPECT_EQ(source.produced, 9);
+    EXPECT_EQ(source.bytes_materialized, 9 * sizeof(int));
+
+    std::ostringstream out;
+    big->dump_pipeline(out);
+    EXPECT_NE(out.str().find("- Where: produced=1"), std::string::npos);
+    EXPECT_NE(out.str().find("  - Sequence: produced=9"), std::string::npos);
+
+    Pipeline_Profiler::set_enabled(false);
+}
+
+TEST(LazySequence, ProfilingDisabledByDefault)
+{
+    Array_Sequence<int> seq;
+    seq.append(1);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    lazy->get(0);
+
+    EXPECT_EQ(lazy->get_counters().produced, 0);
+    EXPECT_EQ(lazy->get_counters().bytes_materialized, sizeof(int));
+}
+
+TEST(LazySequence, CompressedArithmeticProgression)
+{
+    Array_Sequence<int> start;
+    start.append(5);
+
+    auto plus_three = [](const Sequence<int>& s) { return s.get(s.get_size() - 1) + 3; };
+    auto lazy = Lazy_Sequence<int>::create(start, 1, plus_three);
+    lazy->enable_compression();
+
+    EXPECT_TRUE(lazy->is_compressed());
+    EXPECT_EQ(lazy->get(10000), 5 + 3 * 10000);
+    EXPECT_EQ(lazy->get_materialized_count(), 10001);
+
+    for (int i = 0; i <= 10000; i += 37)
+        EXPECT_EQ(lazy->get(i), 5 + 3 * i);
+
+    EXPECT_EQ(lazy->get_first_materialized(), 5);
+    EXPECT_EQ(lazy->get_last_materialized(), 30005);
+    EXPECT_LT(lazy->get_materialized_bytes() * 10, 10001 * sizeof(int));
+    EXPECT_EQ(lazy->get_materialized_data(), nullptr);
+}
+
+TEST(LazySequence, CompressionKeepsExistingPrefixAndArbitraryValues)
+{
+    Array_Sequence<long long> seq;
+    unsigned long long state = 12345;
+    for (int i = 0; i < 1000; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        seq.append((long long)state >> (i % 64));
+    }
+
+    auto lazy = Lazy_Sequence<long long>::create(seq);
+    EXPECT_EQ(lazy->get(299), seq.get(299));
+
+    lazy->enable_compression();
+    EXPECT_EQ(lazy->get_materialized_count(), 300);
+
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(lazy->get(i), seq.get(i));
+
+    long long out[500];
+    lazy->copy_materialized(250, 500, out);
+    for (int i = 0; i < 500; ++i)
+        EXPECT_EQ(out[i], seq.get(250 + i));
+}
+
+TEST(LazySequence, CompressionOnlyForIntegers)
+{
+    Array_Sequence<double> seq;
+    seq.append(1.5);
+
+    auto lazy = Lazy_Sequence<double>::create(seq);
+    EXPECT_THROW(lazy->enable_compression(), std::runtime_error);
+}
+
+TEST(LazySequence, CheckpointFunctionSequence)
+{
+    std::string path = ::testing::TempDir() + "checkpoint_fib.bin";
+
+    Array_Sequence<long long> start;
+    start.append(0);
+    start.append(1);
+
+    int generated = 0;
+    auto fib = [&generated](const Array_Sequence<long long>& s) {
+        ++generated;
+        size_t n = s.get_size();
+        return s.get(n - 1) + s.get(n - 2);
+    };
+
+    auto lazy = Lazy_Sequence<long long>::create(start, 2, fib);
+    EXPECT_EQ(lazy->get(50), 12586269025LL);
+    lazy->save(path);
+
+    generated = 0;
+    auto restored = Lazy_Sequence<long long>::load(path, 2, fib);
+
+    EXPECT_EQ(restored->get_materialized_count(), 51);
+    EXPECT_EQ(restored->get(50), 12586269025LL);
+    EXPECT_EQ(generated, 0);
+
+    EXPECT_EQ(restored->get(51), 20365011074LL);
+    EXPECT_EQ(generated, 1);
+}
+
+TEST(LazySequence, CheckpointRestoresGeneratorCursor)
+{
+    std::string base_path = ::testing::TempDir() + "checkpoint_base.bin";
+    std::string where_path = ::testing::TempDir() + "checkpoint_where.bin";
+
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 20; ++i)
+        seq.append(i);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    auto evens = lazy->where([](int x) { return x % 2 == 0; });
+
+    EXPECT_EQ(evens->get(2), 4);
+    EXPECT_TRUE(evens->has_next());
+
+    lazy->save(base_path);
+    evens->save(where_path);
+
+    auto restored_base = Lazy_Sequence<int>::load(base_path,
+        my::make_unique<Sequence_Generator<int>>(seq));
+    auto restored_evens = Lazy_Sequence<int>::load(where_path,
+        my::make_unique<Where_Generator<int>>(restored_base, [](const int& x) { return x % 2 == 0; }));
+
+    EXPECT_EQ(restored_base->get_materialized_count(), lazy->get_materialized_count());
+    EXPECT_EQ(restored_evens->get_materialized_count(), 3);
+    EXPECT_EQ(restored_evens->get(3), 6);
+    EXPECT_EQ(restored_evens->get(9), 18);
+    EXPECT_FALSE(restored_evens->has_next());
+}
+
+TEST(LazySequence, CheckpointRejectsWrongElementSize)
+{
+    std::string path = ::testing::TempDir() + "checkpoint_size.bin";
+
+    Array_Sequence<int> seq;
+    seq.append(1);
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    lazy->get(0);
+    lazy->save(path);
+
+    Array_Sequence<long long> other;
+    EXPECT_THROW(Lazy_Sequence<long long>::load(path,
+        my::make_unique<Sequence_Generator<long long>>(other)), std::runtime_error);
+}
+
+TEST(LazySequence, CheckpointRejectsMismatchedGenerator)
+{
+    std::string path = ::testing::TempDir() + "checkpoint_mismatch.bin";
+
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 5; ++i)
+        seq.append(i);
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    auto joined = lazy->append(Lazy_Sequence<int>::create(seq));
+    joined->get(1);
+    joined->save(path);
+
+    // у Concat два числа состояния, у Sequence одно
+    try {
+        Lazy_Sequence<int>::load(path, my::make_unique<Sequence_Generator<int>>(seq));
+        FAIL() << "Mismatched checkpoint was accepted";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("Bad checkpoint"), std::string::npos);
+    }
+}
+
+TEST(LazySequence, CheckpointRejectsHugeCount)
+{
+    std::string path = ::testing::TempDir() + "checkpoint_huge.bin";
+
+    Checkpoint_Header header;
+    std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+    header.version = checkpoint_version;
+    header.element_size = sizeof(int);
+    header.count = (uint64_t)std::numeric_limits<int>::max() + 1;
+    header.state_count = 0;
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    Array_Sequence<int> seq;
+    try {
+        Lazy_Sequence<int>::load(path, my::make_unique<Sequence_Generator<int>>(seq));
+        FAIL() << "Huge checkpoint was accepted";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("Bad checkpoint"), std::string::npos);
+    }
+}
+
+TEST(LazySequence, RollingMedianAndQuantile) {
+    Array_Sequence<int> seq;
+    for (int x : {5, 1, 4, 2, 8, 7, 3})
+        seq.append(x);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+
+    auto median = rolling_median(lazy, 3);
+    double expected[] = {5, 3, 4, 2, 4, 7, 7};
+    for (size_t i = 0; i < 7; ++i)
+        EXPECT_DOUBLE_EQ(median->get(i), expected[i]);
+    EXPECT_FALSE(median->has_next());
+
+    auto maximum = rolling_quantile(lazy, 3, 1.0);
+    EXPECT_DOUBLE_EQ(maximum->get(3), 4);
+    EXPECT_DOUBLE_EQ(maximum->get(6), 8);
+
+    EXPECT_THROW(rolling_quantile(lazy, 3, 2.0), std::invalid_argument);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "StaticLazySequence.hpp"
+#include "ArraySequence.hpp"
+
+TEST(StaticLazySequence, CreateFromSequence) {
+    Array_Sequence<int> seq;
+    seq.append(1);
+    seq.append(2);
+    seq.append(3);
+
+    auto lazy = make_static_lazy_sequence(seq);
+
+    EXPECT_EQ(lazy.get(0), 1);
+    EXPECT_EQ(lazy.get(2), 3);
+    EXPECT_EQ(lazy.get_materialized_count(), 3);
+    EXPECT_FALSE(lazy.has_next());
+    EXPECT_THROW(lazy.get(3), std::runtime_error);
+}
+
+TEST(StaticLazySequence, FunctionRule) {
+    Array_Sequence<int> start;
+    start.append(0);
+    start.append(1);
+
+    auto fib = [](const Sequence<int>& s) {
+        int n = s.get_size();
+        return s.get(n - 1) + s.get(n - 2);
+    };
+
+    auto lazy = make_static_lazy_sequence(start, 2, fib);
+
+    EXPECT_EQ(lazy.get_materialized_count(), 0);
+    EXPECT_EQ(lazy.get(6), 8);
+    EXPECT_EQ(lazy.get_materialized_count(), 7);
+    EXPECT_EQ(lazy.get_next(), 13);
+}
+
+TEST(StaticLazySequence, MapThenWhere) {
+    Array_Sequence<int> seq;
+    for (int i = 1; i <= 10; ++i)
+        seq.append(i);
+
+    auto result = make_static_lazy_sequence(seq)
+        .map([](int x) { return x * x; })
+        .where([](int x) { return x % 2 == 0; });
+
+    EXPECT_EQ(result.get(0), 4);
+    EXPECT_EQ(result.get(1), 16);
+    EXPECT_EQ(result.get(4), 100);
+    EXPECT_FALSE(result.has_next());
+}
+
+TEST(StaticLazySequence, MapChangesType) {
+    Array_Sequence<int> seq;
+    seq.append(1);
+    seq.append(2);
+
+    auto halves = make_static_lazy_sequence(seq).map([](int x) { return x / 2.0; });
+
+    EXPECT_DOUBLE_EQ(halves.get(0), 0.5);
+    EXPECT_DOUBLE_EQ(halves.get(1), 1.0);
+}
+
+TEST(StaticLazySequence, StagesStartFromSource) {
+    Array_Sequence<int> seq;
+    seq.append(1);
+    seq.append(2);
+    seq.append(3);
+
+    auto base = make_static_lazy_sequence(seq);
+    EXPECT_EQ(base.get(1), 2);
+
+    auto doubled = base.map([](int x) { return x * 2; });
+    EXPECT_EQ(doubled.get(0), 2);
+    EXPECT_EQ(doubled.get(2), 6);
+}
+
+TEST(StaticLazySequence, AppendAndPrepend) {
+    Array_Sequence<int> a;
+    a.append(1);
+    a.append(2);
+
+    Array_Sequence<int> b;
+    b.append(3);
+
+    auto la = make_static_lazy_sequence(a);
+    auto lb = make_static_lazy_sequence(b);
+
+    auto appended = la.append(lb);
+    EXPECT_EQ(appended.get(0), 1);
+    EXPECT_EQ(appended.get(2), 3);
+
+    auto prepended = la.prepend(lb);
+    EXPECT_EQ(prepended.get(0), 3);
+    EXPECT_EQ(prepended.get(2), 2);
+}
+
+TEST(StaticLazySequence, EraseToLazySequence) {
+    Array_Sequence<int> seq;
+    for (int i = 0; i < 5; ++i)
+        seq.append(i);
+
+    auto erased = make_static_lazy_sequence(seq)
+        .map([](int x) { return x + 10; })
+        .erase();
+
+    auto filtered = erased->where([](int x) { return x > 11; });
+
+    EXPECT_EQ(erased->get(0), 10);
+    EXPECT_EQ(filtered->get(0), 12);
+    EXPECT_EQ(filtered->get(2), 14);
+}
+
+TEST(StaticLazySequence, DoesNotOverGenerate) {
+    int generated = 0;
+
+    Array_Sequence<int> start;
+    start.append(0);
+    start.append(1);
+
+    auto rule = [&generated](const Sequence<int>& s) {
+        ++generated;
+        int n = s.get_size();
+        return s.get(n - 1) + s.get(n - 2);
+    };
+
+    auto lazy = make_static_lazy_sequence(start, 2, rule);
+
+    EXPECT_TRUE(lazy.has_next());
+    EXPECT_EQ(lazy.get(1), 1);
+    EXPECT_EQ(generated, 0);
+
+    EXPECT_EQ(lazy.get(2), 1);
+    EXPECT_EQ(generated, 1);
+
+    EXPECT_EQ(lazy.get(2), 1);
+    EXPECT_EQ(generated, 1);
+}
@@ -0,0 +1,640 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+#include "RunningMedian.hpp"
+#include "RunningQuantile.hpp"
+#include "WindowedMedian.hpp"
+#include "WindowedQuantile.hpp"
+#include "QuantileSketch.hpp"
+#include "LazySequence.hpp"
+#include "NumberStatistics.hpp"
+#include "PipelineStatistics.hpp"
+#include "FrequencySketch.hpp"
+#include "TopKFrequent.hpp"
+#include "DistinctCounter.hpp"
+
+static double sorted_median(std::vector<int> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t size = values.size();
+    if (size % 2 == 1) return values[size / 2];
+    return (values[size / 2 - 1] + (double)values[size / 2]) / 2.0;
+}
+
+TEST(RunningMedian, EmptyThrows)
+{
+    Running_Median<int> median;
+    EXPECT_THROW(median.get_median(), std::runtime_error);
+}
+
+TEST(RunningMedian, OddAndEvenCounts)
+{
+    Running_Median<int> median;
+    median.add(5);
+    EXPECT_DOUBLE_EQ(median.get_median(), 5);
+
+    median.add(1);
+    EXPECT_DOUBLE_EQ(median.get_median(), 3);
+
+    median.add(10);
+    EXPECT_DOUBLE_EQ(median.get_median(), 5);
+
+    median.add(2);
+    EXPECT_DOUBLE_EQ(median.get_median(), 3.5);
+
+    median.clear();
+    EXPECT_EQ(median.get_size(), 0);
+    EXPECT_THROW(median.get_median(), std::runtime_error);
+}
+
+TEST(RunningMedian, CountsDuplicates)
+{
+    Running_Median<int> median;
+    for (int x : {7, 7, 7, 1})
+        median.add(x);
+
+    EXPECT_DOUBLE_EQ(median.get_median(), 7);
+    EXPECT_EQ(median.get_size(), 4);
+}
+
+TEST(RunningMedian, MatchesSortedReference)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> values(-1000, 1000);
+
+    Running_Median<int> median;
+    std::vector<int> seen;
+    for (int i = 0; i < 2000; ++i) {
+        int x = values(random);
+        median.add(x);
+        seen.push_back(x);
+        ASSERT_DOUBLE_EQ(median.get_median(), sorted_median(seen));
+    }
+}
+
+TEST(OrderStatisticTree, SelectRankWithDuplicates)
+{
+    OrderStatisticTree<int> tree;
+    for (int x : {5, 3, 8, 3, 3, 9, 1})
+        tree.insert(x);
+
+    EXPECT_EQ(tree.get_size(), 7);
+    EXPECT_EQ(tree.count(3), 3);
+
+    int expected[] = {1, 3, 3, 3, 5, 8, 9};
+    for (size_t k = 0; k < 7; ++k)
+        EXPECT_EQ(tree.select(k), expected[k]);
+
+    EXPECT_EQ(tree.rank(3), 1);
+    EXPECT_EQ(tree.rank(4), 4);
+    EXPECT_EQ(tree.rank(100), 7);
+    EXPECT_THROW(tree.select(7), std::out_of_range);
+
+    tree.erase(3);
+    EXPECT_EQ(tree.count(3), 2);
+    EXPECT_EQ(tree.select(3), 5);
+    EXPECT_THROW(tree.erase(42), std::runtime_error);
+}
+
+TEST(OrderStatisticTree, StaysBalanced)
+{
+    OrderStatisticTree<int> tree;
+    for (int i = 0; i < (1 << 16); ++i)
+        tree.insert(i);
+
+    EXPECT_LE(tree.get_height(), 24);
+
+    for (int i = 0; i < (1 << 16); i += 2)
+        tree.erase(i);
+
+    EXPECT_EQ(tree.get_size(), 1 << 15);
+    EXPECT_EQ(tree.select(0), 1);
+    EXPECT_EQ(tree.rank(1001), 500);
+    EXPECT_LE(tree.get_height(), 23);
+
+    OrderStatisticTree<int> copy = tree;
+    tree.clear();
+    EXPECT_EQ(copy.get_size(), 1 << 15);
+    EXPECT_EQ(copy.select(100), 201);
+}
+
+TEST(RunningQuantile, MatchesSortedReference)
+{
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> values(0, 100);
+
+    Running_Quantile<int> quantile;
+    std::vector<int> seen;
+    for (int i = 0; i < 3000; ++i) {
+        int x = values(random);
+        quantile.insert(x);
+        seen.push_back(x);
+
+        if (i % 5 == 4) {
+            quantile.erase(seen.front());
+            seen.erase(seen.begin());
+        }
+    }
+
+    std::sort(seen.begin(), seen.end());
+    EXPECT_EQ(quantile.get_size(), seen.size());
+    EXPECT_DOUBLE_EQ(quantile.get_median(), sorted_median(seen));
+    EXPECT_DOUBLE_EQ(quantile.quantile(0.0), seen.front());
+    EXPECT_DOUBLE_EQ(quantile.quantile(1.0), seen.back());
+
+    double position = 0.9 * (seen.size() - 1);
+    size_t lower = (size_t)position;
+    double expected = seen[lower] + (position - lower) * (seen[lower + 1] - seen[lower]);
+    EXPECT_DOUBLE_EQ(quantile.quantile(0.9), expected);
+
+    EXPECT_THROW(quantile.quantile(1.5), std::invalid_argument);
+    quantile.clear();
+    EXPECT_THROW(quantile.quantile(0.5), std::runtime_error);
+}
+
+TEST(WindowedMedian, MatchesSortedWindow)
+{
+    std::mt19937 random(3);
+    std::uniform_int_distribution<int> values(0, 50);
+
+    const size_t window = 17;
+    Windowed_Median<int> median(window);
+    Windowed_Quantile<int> quantile(window);
+    std::vector<int> seen;
+
+    for (int i = 0; i < 3000; ++i) {
+        int x = values(random);
+        median.add(x);
+        quantile.add(x);
+        seen.push_back(x);
+
+        std::vector<int> last(seen.end() - std::min(seen.size(), window), seen.end());
+        ASSERT_EQ(median.get_size(), last.size());
+        ASSERT_DOUBLE_EQ(median.get_median(), sorted_median(last));
+        ASSERT_DOUBLE_EQ(quantile.get_median(), sorted_median(last));
+
+        std::sort(last.begin(), last.end());
+        ASSERT_DOUBLE_EQ(quantile.quantile(1.0), last.back());
+    }
+
+    median.clear();
+    EXPECT_THROW(median.get_median(), std::runtime_error);
+    EXPECT_THROW(Windowed_Quantile<int>(0), std::invalid_argument);
+}
+
+TEST(QuantileSketch, ExactWhileSmall)
+{
+    Quantile_Sketch<int> sketch(64);
+    EXPECT_THROW(sketch.quantile(0.5), std::runtime_error);
+
+    for (int i = 1; i <= 11; ++i)
+        sketch.add(i);
+
+    EXPECT_EQ(sketch.quantile(0.5), 6);
+    EXPECT_EQ(sketch.quantile(0.0), 1);
+    EXPECT_EQ(sketch.quantile(1.0), 11);
+    EXPECT_EQ(sketch.rank(4), 3);
+    EXPECT_THROW(Quantile_Sketch<int>(2), std::invalid_argument);
+}
+
+TEST(QuantileSketch, BoundedMemoryAndError)
+{
+    const int n = 1000000;
+    Quantile_Sketch<int> sketch(200);
+
+    std::mt19937 random(11);
+    std::vector<int> values(n);
+    for (int i = 0; i < n; ++i) values[i] = i;
+    std::shuffle(values.begin(), values.end(), random);
+
+    for (int x : values)
+        sketch.add(x);
+
+    EXPECT_EQ(sketch.get_count(), n);
+    EXPECT_LT(sketch.get_retained(), 1000);
+
+    for (double q : {0.01, 0.1, 0.5, 0.9, 0.99}) {
+        double error = std::abs(sketch.quantile(q) - q * n) / n;
+        EXPECT_LT(error, 3 * sketch.get_error()) << "q = " << q;
+    }
+
+    double rank_error = std::abs((double)sketch.rank(n / 4) - n / 4) / n;
+    EXPECT_LT(rank_error, 3 * sketch.get_error());
+}
+
+TEST(QuantileSketch, MergeShards)
+{
+    const int n = 200000;
+    Quantile_Sketch<int> merged(128);
+    Quantile_Sketch<int> shards[4] = {
+        Quantile_Sketch<int>(128), Quantile_Sketch<int>(128),
+        Quantile_Sketch<int>(128), Quantile_Sketch<int>(128)
+    };
+
+    for (int i = 0; i < n; ++i)
+        shards[i % 4].add(i);
+
+    for (const auto& shard : shards)
+        merged.merge(shard);
+
+    EXPECT_EQ(merged.get_count(), n);
+    EXPECT_EQ(merged.quantile(0.0), 0);
+    EXPECT_EQ(merged.quantile(1.0), n - 1);
+    EXPECT_LT(std::abs(merged.quantile(0.5) - n / 2.0) / n, 3 * merged.get_error());
+
+    EXPECT_THROW(merged.merge(Quantile_Sketch<int>(64)), std::invalid_argument);
+}
+
+TEST(NumberStatistics, MeanAndVariance)
+{
+    Number_Statistics<int> stats;
+    EXPECT_THROW(stats.get_mean(), std::runtime_error);
+
+    for (int x : {2, 4, 4, 4, 5, 5, 7, 9})
+        stats.consume(x);
+
+    EXPECT_EQ(stats.get_count(), 8);
+    EXPECT_EQ(stats.get_sum(), 40);
+    EXPECT_DOUBLE_EQ(stats.get_mean(), 5);
+    EXPECT_DOUBLE_EQ(stats.get_variance(), 4);
+    EXPECT_DOUBLE_EQ(stats.get_stddev(), 2);
+    EXPECT_DOUBLE_EQ(stats.get_sample_variance(), 32.0 / 7);
+    EXPECT_EQ(stats.get_min(), 2);
+    EXPECT_EQ(stats.get_max(), 9);
+}
+
+TEST(NumberStatistics, IntegerSumDoesNotOverflow)
+{
+    Number_Statistics<int> stats;
+    for (int i = 0; i < 1000; ++i)
+        stats.consume(std::numeric_limits<int>::max());
+
+    EXPECT_EQ(stats.get_sum(), 1000LL * std::numeric_limits<int>::max());
+    EXPECT_DOUBLE_EQ(stats.get_mean(), std::numeric_limits<int>::max());
+    EXPECT_DOUBLE_EQ(stats.get_variance(), 0);
+
+    Number_Statistics<long long> wide;
+    wide.consume(std::numeric_limits<long long>::max());
+    wide.consume(std::numeric_limits<long long>::max());
+    EXPECT_TRUE(wide.is_sum_overflowed());
+    EXPECT_THROW(wide.get_sum(), std::overflow_error);
+    EXPECT_DOUBLE_EQ((double)wide.get_sum_approx(), 2.0 * std::numeric_limits<long long>::max());
+
+    wide.consume(std::numeric_limits<long long>::min());
+    EXPECT_FALSE(wide.is_sum_overflowed());
+    EXPECT_EQ(wide.get_sum(), std::numeric_limits<long long>::max() - 1);
+}
+
+TEST(NumberStatistics, CompensatedFloatingSum)
+{
+    Number_Statistics<double> stats;
+    stats.consume(1e16);
+    for (int i = 0; i < 1000; ++i)
+        stats.consume(1.0);
+    stats.consume(-1e16);
+
+    EXPECT_DOUBLE_EQ(stats.get_sum(), 1000.0);
+}
+
+TEST(NumberStatistics, MergeMatchesSinglePass)
+{
+    std::mt19937 random(5);
+    std::normal_distribution<double> values(100.0, 15.0);
+
+    Number_Statistics<double> whole;
+    Number_Statistics<double> shards[3];
+    for (int i = 0; i < 10000; ++i) {
+        double x = values(random);
+        whole.consume(x);
+        shards[i % 3].consume(x);
+    }
+
+    Number_Statistics<double> merged;
+    for (const auto& shard : shards)
+        merged.merge(shard);
+
+    EXPECT_EQ(merged.get_count(), whole.get_count());
+    EXPECT_NEAR(merged.get_mean(), whole.get_mean(), 1e-9);
+    EXPECT_NEAR(merged.get_variance(), whole.get_variance(), 1e-6);
+    EXPECT_EQ(merged.get_min(), whole.get_min());
+    EXPECT_EQ(merged.get_max(), whole.get_max());
+    EXPECT_NEAR(merged.get_sum(), whole.get_sum(), 1e-6);
+}
+
+TEST(NumberStatistics, BatchMatchesElementwise)
+{
+    std::mt19937 random(9);
+    std::uniform_int_distribution<int> values(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+
+    for (size_t n : {1u, 7u, 17u, 2048u, 5003u}) {
+        std::vector<int> data(n);
+        for (int& x : data) x = values(random);
+
+        Number_Statistics<int> single;
+        for (int x : data) single.consume(x);
+
+        Number_Statistics<int> batch;
+        batch.consume_batch(data.data(), n);
+
+        EXPECT_EQ(batch.get_count(), n);
+        EXPECT_EQ(batch.get_sum(), single.get_sum());
+        EXPECT_EQ(batch.get_min(), single.get_min());
+        EXPECT_EQ(batch.get_max(), single.get_max());
+        EXPECT_NEAR(batch.get_variance(), single.get_variance(), single.get_variance() * 1e-9);
+    }
+
+    EXPECT_STRNE(get_int_kernel_name(), "");
+}
+
+TEST(NumberStatistics, BatchFromSequenceAndView)
+{
+    Array_Sequence<int> seq;
+    for (int i = 1; i <= 100; ++i)
+        seq.append(i);
+
+    Number_Statistics<int> stats;
+    stats.consume_batch(seq);
+
+    auto lazy = Lazy_Sequence<int>::create(seq);
+    Lazy_Read_Only_Stream<int> stream(lazy);
+    for (Stream_View<int> view = stream.read_view(30); !view.empty(); view = stream.read_view(30))
+        stats.consume_batch(view);
+
+    EXPECT_EQ(stats.get_count(), 200);
+    EXPECT_EQ(stats.get_sum(), 10100);
+    EXPECT_DOUBLE_EQ(stats.get_mean(), 50.5);
+
+    Number_Statistics<double> floating;
+    double data[] = {1.5, 2.5, 3.5};
+    floating.consume_batch(data, 3);
+    EXPECT_DOUBLE_EQ(floating.get_mean(), 2.5);
+}
+
+static Shared_Ptr<Lazy_Sequence<int>> make_range(int from, int to)
+{
+    Array_Sequence<int> seq;
+    for (int i = from; i < to; ++i)
+        seq.append(i);
+    return Lazy_Sequence<int>::create(seq);
+}
+
+TEST(PipelineStatistics, AppendKeepsPrefix)
+{
+    auto pipeline = make_range(0, 5000);
+    Pipeline_Statistics<int> stats(pipeline, 256, quantile_exact);
+
+    stats.advance_to(3000);
+    EXPECT_EQ(stats.get_summary().get_count(), 3000);
+    EXPECT_EQ(stats.get_read_count(), 3000);
+
+    auto appended = pipeline->append(make_range(0, 10));
+    EXPECT_EQ(appended->get_shared_prefix(pipeline.get()), std::numeric_limits<size_t>::max());
+
+    stats.rebind(appended);
+    stats.advance_to(3100);
+    EXPECT_EQ(stats.get_summary().get_count(), 3100);
+    EXPECT_EQ(stats.get_read_count(), 3100);
+    EXPECT_DOUBLE_EQ(stats.get_exact().get_median(), 1549.5);
+}
+
+TEST(PipelineStatistics, InsertRecomputesOnlySuffix)
+{
+    auto pipeline = make_range(0, 5000);
+    Pipeline_Statistics<int> stats(pipeline, 256, quantile_exact);
+    stats.advance_to(4000);
+    EXPECT_EQ(stats.get_summary().get_count(), 4000);
+
+    auto inserted = pipeline->insert_at(3001, make_range(-100, -90));
+    EXPECT_EQ(inserted->get_shared_prefix(pipeline.get()), 3000);
+
+    stats.rebind(inserted);
+    EXPECT_EQ(stats.get_consumed_count(), 3000);
+
+    const auto& summary = stats.get_summary();
+    EXPECT_EQ(stats.get_read_count(), 4000 + 1000);
+
+    Number_Statistics<int> reference;
+    for (size_t i = 0; i < 4000; ++i)
+        reference.consume(inserted->get(i));
+
+    EXPECT_EQ(summary.get_count(), 4000);
+    EXPECT_EQ(summary.get_sum(), reference.get_sum());
+    EXPECT_EQ(summary.get_min(), -100);
+    EXPECT_NEAR(summary.get_variance(), reference.get_variance(), 1e-6);
+    EXPECT_EQ(stats.get_exact().select(0), -100);
+    EXPECT_EQ(stats.get_exact().get_size(), 4000);
+}
+
+TEST(PipelineStatistics, MapRecomputesEverything)
+{
+    auto pipeline = make_range(0, 100);
+    Pipeline_Statistics<int> stats(pipeline, 16);
+    stats.advance_to(50);
+    EXPECT_EQ(stats.get_summary().get_sum(), 1225);
+
+    auto doubled = pipeline->map<int>([](const int& x) { return 2 * x; });
+    EXPECT_EQ(doubled->get_shared_prefix(pipeline.get()), 0);
+
+    stats.rebind(doubled);
+    EXPECT_EQ(stats.get_summary().get_sum(), 2450);
+    EXPECT_DOUBLE_EQ(stats.get_sketch().quantile(1.0), 98);
+}
+
+TEST(PipelineStatistics, SnapshotMemoryIsBounded)
+{
+    auto pipeline = make_range(0, 200000);
+    Pipeline_Statistics<int> stats(pipeline, 16);
+
+    stats.advance_to(100000);
+    EXPECT_EQ(stats.get_summary().get_count(), 100000);
+    EXPECT_LE(stats.get_snapshot_count(), 32);
+    size_t memory = stats.get_snapshot_memory();
+
+    // при снимке каждые 16 элементов их было бы 12500
+    stats.advance_to(200000);
+    EXPECT_EQ(stats.get_summary().get_count(), 200000);
+    EXPECT_LE(stats.get_snapshot_count(), 32);
+    EXPECT_LT(stats.get_snapshot_memory(), memory * 3 / 2);
+
+    // после прореживания откат по-прежнему точный
+    auto inserted = pipeline->insert_at(150001, make_range(-100, -90));
+    stats.rebind(inserted);
+    EXPECT_EQ(stats.get_consumed_count(), 150000);
+
+    Number_Statistics<int> reference;
+    for (size_t i = 0; i < 200000; ++i)
+        reference.consume(inserted->get(i));
+
+    const auto& summary = stats.get_summary();
+    EXPECT_EQ(summary.get_count(), 200000);
+    EXPECT_EQ(summary.get_sum(), reference.get_sum());
+    EXPECT_EQ(summary.get_min(), -100);
+}
+
+TEST(PipelineStatistics, KeepsOnlyChosenEstimator)
+{
+    auto pipeline = make_range(0, 1000);
+
+    Pipeline_Statistics<int> exact(pipeline, 64, quantile_exact);
+    exact.advance_to(1000);
+    EXPECT_DOUBLE_EQ(exact.get_quantile(0.5), 499.5);
+    EXPECT_THROW(exact.get_sketch(), std::runtime_error);
+
+    Pipeline_Statistics<int> sketch(pipeline, 64, quantile_sketch);
+    sketch.advance_to(1000);
+    EXPECT_NEAR(sketch.get_quantile(0.5), 499.5, 1000 * sketch.get_sketch().get_error() * 3);
+    EXPECT_THROW(sketch.get_exact(), std::runtime_error);
+}
+
+// значение i встречается примерно пропорционально 1 / (i + 1)
+static std::vector<int> skewed_stream(size_t n, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::vector<double> weights(1000);
+    for (size_t i = 0; i < weights.size(); ++i) weights[i] = 1.0 / (i + 1);
+
+    std::discrete_distribution<int> values(weights.begin(), weights.end());
+    std::vector<int> result(n);
+    for (int& x : result) x = values(random);
+    return result;
+}
+
+TEST(FrequencySketch, NeverUnderestimates)
+{
+    auto data = skewed_stream(100000, 1);
+    std::vector<uint64_t> exact(1000, 0);
+    for (int x : data) exact[x]++;
+
+    auto sketch = Frequency_Sketch<int>::with_error(0.001, 0.01);
+    sketch.add_batch(data.data(), data.size());
+    EXPECT_EQ(sketch.get_total(), data.size());
+
+    for (int value = 0; value < 1000; ++value) {
+        ASSERT_GE(sketch.estimate(value), exact[value]);
+        ASSERT_LE(sketch.estimate(value), exact[value] + 0.001 * 100000 * 3);
+    }
+    EXPECT_EQ(sketch.estimate(5000), 0);
+}
+
+TEST(FrequencySketch, MergeAndConsumeSequence)
+{
+    auto sequence = make_range(0, 1000);
+
+    Frequency_Sketch<int> first(256, 4);
+    Frequency_Sketch<int> second(256, 4);
+    EXPECT_EQ(first.consume(sequence, 600), 600);
+
+    Lazy_Read_Only_Stream<int> stream(sequence);
+    stream.seek(600);
+    EXPECT_EQ(second.consume(stream), 400);
+
+    first.merge(second);
+    EXPECT_EQ(first.get_total(), 1000);
+    EXPECT_GE(first.estimate(999), 1);
+    EXPECT_THROW(first.merge(Frequency_Sketch<int>(128, 4)), std::invalid_argument);
+}
+
+TEST(TopKFrequent, FindsHeavyHitters)
+{
+    auto data = skewed_stream(100000, 2);
+    std::vector<uint64_t> exact(1000, 0);
+    for (int x : data) exact[x]++;
+
+    Top_K_Frequent<int> top(50);
+    top.add_batch(data.data(), data.size());
+
+    auto best = top.top(5);
+    ASSERT_EQ(best.size(), 5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(best[i].value, i);
+        EXPECT_GE(best[i].count, exact[i]);
+        EXPECT_LE(best[i].count - best[i].error, exact[i]);
+    }
+    EXPECT_THROW(Top_K_Frequent<int>(0), std::invalid_argument);
+}
+
+TEST(TopKFrequent, MergeShards)
+{
+    auto data = skewed_stream(60000, 3);
+
+    Top_K_Frequent<int> whole(40);
+    Top_K_Frequent<int> left(40);
+    Top_K_Frequent<int> right(40);
+    whole.add_batch(data.data(), data.size());
+    left.add_batch(data.data(), 30000);
+    right.add_batch(data.data() + 30000, 30000);
+
+    left.merge(right);
+    EXPECT_EQ(left.get_total(), 60000);
+
+    auto merged = left.top(3);
+    auto single = whole.top(3);
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ(merged[i].value, single[i].value);
+
+    std::vector<uint64_t> exact(1000, 0);
+    for (int x : data) exact[x]++;
+    for (const auto& item : merged) {
+        EXPECT_GE(item.count, exact[item.value]);
+        EXPECT_LE(item.count - item.error, exact[item.value]);
+    }
+}
+
+TEST(DistinctCounter, SparseIsNearlyExact)
+{
+    Distinct_Counter<int> counter;
+    EXPECT_DOUBLE_EQ(counter.estimate(), 0);
+
+    for (int repeat = 0; repeat < 3; ++repeat)
+        for (int i = 0; i < 1000; ++i)
+            counter.add(i);
+
+    EXPECT_TRUE(counter.is_sparse());
+    EXPECT_NEAR(counter.estimate(), 1000, 2);
+    EXPECT_THROW(Distinct_Counter<int>(3), std::invalid_argument);
+}
+
+TEST(DistinctCounter, DenseWithinError)
+{
+    for (int n : {5000, 50000, 1000000}) {
+        Distinct_Counter<int> counter(12);
+        std::vector<int> data(n);
+        for (int i = 0; i < n; ++i) data[i] = i * 7 + 3;
+        counter.add_batch(data.data(), n);
+
+        EXPECT_FALSE(counter.is_sparse());
+        EXPECT_NEAR(counter.estimate(), n, n * 4 * counter.get_error()) << "n = " << n;
+        EXPECT_LE(counter.get_memory_usage(), 8192);
+    }
+}
+
+TEST(DistinctCounter, MergeMixedRepresentations)
+{
+    Distinct_Counter<int> small;
+    Distinct_Counter<int> large;
+    Distinct_Counter<int> whole;
+
+    for (int i = 0; i < 500; ++i) {
+        small.add(i);
+        whole.add(i);
+    }
+    for (int i = 250; i < 200000; ++i) {
+        large.add(i);
+        whole.add(i);
+    }
+
+    Distinct_Counter<int> sparse_into_dense = large;
+    sparse_into_dense.merge(small);
+    small.merge(large);
+
+    EXPECT_NEAR(small.estimate(), whole.estimate(), 1e-6);
+    EXPECT_NEAR(sparse_into_dense.estimate(), whole.estimate(), 1e-6);
+    EXPECT_NEAR(whole.estimate(), 200000, 200000 * 4 * whole.get_error());
+
+    auto sequence = make_range(0, 3000);
+    Distinct_Counter<int> from_sequence;
+    EXPECT_EQ(from_sequence.consume(sequence, 2000), 2000);
+    EXPECT_NEAR(from_sequence.estimate(), 2000, 5);
+}